@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <nlohmann/json.hpp>
+using nlohmann::json;
+
+#include <ytcpp/core/cache.hpp>
+#include <ytcpp/core/error.hpp>
+#include <ytcpp/core/js.hpp>
+#include <ytcpp/core/url.hpp>
+#include <ytcpp/cipher.hpp>
+#include <ytcpp/format.hpp>
+#include <ytcpp/player.hpp>
+#include <ytcpp/playlist.hpp>
+#include <ytcpp/yt_error.hpp>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// Same shapes as the signature function, its helper object and the n function found in player code.
+namespace Synthetic {
+    constexpr const char* PlayerId = "synthetic";
+    constexpr const char* SigFunction = R"(Xka=function(a){a=a.split("");Wy.Hq(a,3);Wy["AS"](a,45);Wy.dK(a,1);Wy.Hq(a,11);Wy.AS(a,39);return a.join("")})";
+    constexpr const char* SignatureObject = R"(var Wy={dK:function(a){a.reverse()},
+AS:function(a,b){var c=a[0];a[0]=a[b%a.length];a[b%a.length]=c},
+"Hq":function(a,b){a.splice(0,b)}};)";
+    constexpr const char* NFunction = R"(Qn=function(a){var b=a.split(""),c=b.length;for(var d=0;d<c;d++){b[d]=String.fromCharCode((b[d].charCodeAt(0)+d)%26+97)}b.reverse();return b.join("")};)";
+    constexpr const char* Signature = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghij";
+    constexpr size_t PlayerCodeSize = 2 << 20;
+    constexpr size_t FormatCount = 25;
+    constexpr size_t PlaylistPageSize = 100;
+    constexpr size_t PlaylistPageCount = 500;
+}
+
+struct PlayerScript {
+    std::string id;
+    std::string code;
+};
+
+static void Measure(const std::string& name, size_t iterations, const std::function<void(size_t iteration)>& body) {
+    Clock::time_point start = Clock::now();
+    for (size_t iteration = 0; iteration < iterations; ++iteration)
+        body(iteration);
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    std::cout << "  " << name << ": " << elapsed.count() / iterations << " us/op (" << iterations << " ops)\n";
+}
+
+static std::string ReadFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Couldn't open \"" + path.string() + "\"");
+    return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+static std::vector<fs::path> CorpusFiles(const std::optional<fs::path>& corpus, const std::string& extension) {
+    std::vector<fs::path> files;
+    if (corpus) {
+        for (const fs::directory_entry& entry : fs::directory_iterator(*corpus)) {
+            if (entry.is_regular_file() && entry.path().extension() == extension)
+                files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+static std::string SyntheticPlayerCode() {
+    // Filler stands in for the rest of base.js, so extraction scans a script of realistic size.
+    std::string code = "var _yt_player={};(function(g){var config={signatureTimestamp:19999};\n";
+    for (size_t index = 0; code.size() < Synthetic::PlayerCodeSize; ++index)
+        code += fmt::format("var f{0}=function(a){{return a.slice({1}).concat(\"f{0}\")}};g.f{0}=f{0};\n", index, index % 7);
+    code += fmt::format("{};\n{}\n{}\n}})(_yt_player);\n", Synthetic::SigFunction, Synthetic::SignatureObject, Synthetic::NFunction);
+    return code;
+}
+
+// Archived base.js files of the corpus are named after their player, a synthetic player is used without any.
+static std::vector<PlayerScript> LoadPlayerScripts(const std::optional<fs::path>& corpus) {
+    std::vector<PlayerScript> scripts;
+    for (const fs::path& path : CorpusFiles(corpus, ".js"))
+        scripts.push_back({ path.stem().string(), ReadFile(path) });
+    if (scripts.empty())
+        scripts.push_back({ Synthetic::PlayerId, SyntheticPlayerCode() });
+    return scripts;
+}
+
+static json SyntheticPlayerResponse() {
+    json formats = json::array();
+    for (size_t index = 0; index < Synthetic::FormatCount; ++index) {
+        std::string url = fmt::format("https://rr1---sn-benchmark.googlevideo.com/videoplayback?expire=4102444800&itag={}&n=benchmark", 100 + index);
+        json format = {
+            {"itag", 100 + index},
+            {"bitrate", 100000 * (index + 1)},
+            {"contentLength", "10000000"},
+            {"approxDurationMs", "212000"},
+            {"signatureCipher", fmt::format("s={}&sp=sig&url={}", Synthetic::Signature, ytcpp::Url::Encode(url))},
+        };
+        if (index % 5 == 0) {
+            format["mimeType"] = R"(audio/webm; codecs="opus")";
+            format["audioChannels"] = 2;
+            format["audioSampleRate"] = "48000";
+        }
+        else {
+            format["mimeType"] = R"(video/mp4; codecs="avc1.640028")";
+            format["width"] = 1920;
+            format["height"] = 1080;
+            format["fps"] = 30;
+        }
+        formats.push_back(std::move(format));
+    }
+    return { {"playabilityStatus", { {"status", "OK"} }}, {"streamingData", { {"adaptiveFormats", std::move(formats)} }} };
+}
+
+// Recorded "player" responses of the corpus are .json files, a synthetic response is used without any.
+static json LoadPlayerResponse(const std::optional<fs::path>& corpus) {
+    std::vector<fs::path> files = CorpusFiles(corpus, ".json");
+    return files.empty() ? SyntheticPlayerResponse() : json::parse(ReadFile(files.front()));
+}
+
+// Every list gets its own n value, so the process-wide nsig cache doesn't hide the JS work.
+static std::string WithNsig(json response, const std::string& nsig) {
+    for (json& format : response.at("streamingData").at("adaptiveFormats")) {
+        if (format.contains("url")) {
+            format["url"] = ytcpp::Url::SetParameter(format.at("url").get<std::string>(), "n", nsig);
+            continue;
+        }
+        std::string cipher = format.at("signatureCipher");
+        std::string url = ytcpp::Url::Query(cipher).get("url").value_or("");
+        format["signatureCipher"] = ytcpp::Url::SetParameter(cipher, "url", ytcpp::Url::SetParameter(url, "n", nsig));
+    }
+    return response.dump();
+}
+
+static std::string CipheredUrl(size_t index) {
+    std::string url = fmt::format("https://rr1---sn-benchmark.googlevideo.com/videoplayback?expire=4102444800&n=url{}n", index);
+    return fmt::format("s={}&sp=sig&url={}", Synthetic::Signature, ytcpp::Url::Encode(url));
+}
+
+static void BenchCipher() {
+    std::optional<ytcpp::Cipher> cipher = ytcpp::Cipher::Compile(Synthetic::SigFunction, Synthetic::SignatureObject);
+    if (!cipher)
+        throw std::runtime_error("Synthetic cipher couldn't be compiled");
+    ytcpp::Js::Interpreter interpreter;
+    interpreter.execute(Synthetic::SigFunction);
+    interpreter.execute(Synthetic::SignatureObject);
+    if (cipher->apply(Synthetic::Signature) != interpreter.execute("Xka(\"{}\")", Synthetic::Signature))
+        throw std::runtime_error("Native and JS ciphers disagree");
+
+    std::cout << "Signature cipher:\n";
+    Measure("native", 100000, [&](size_t) { cipher->apply(Synthetic::Signature); });
+    Measure("js", 10000, [&](size_t) { interpreter.execute("Xka(\"{}\")", Synthetic::Signature); });
+}
+
+static std::shared_ptr<const ytcpp::Player> BenchPlayers(const std::vector<PlayerScript>& scripts) {
+    // Engines are selected at build time, builds with each YtcppJsEngine are compared by their output.
+    std::cout << "Player build (" << ytcpp::Js::Interpreter::EngineVersion() << "):\n";
+    size_t urls = 0;
+    for (const PlayerScript& script : scripts) {
+        std::cout << "  " << script.id << " (" << script.code.size() / 1024 << " KiB):\n";
+        Measure("  from code", 5, [&](size_t) { ytcpp::Player player(script.id, script.code); });
+        Measure("  from snapshot", 20, [&](size_t) { ytcpp::Player player(script.id); });
+        Measure("  from snapshot + first decipher", 20, [&](size_t) {
+            ytcpp::Player player(script.id);
+            player.prepareUrl(CipheredUrl(urls++));
+        });
+
+        ytcpp::Player player(script.id);
+        Measure("  sig + nsig", 1000, [&](size_t) { player.prepareUrl(CipheredUrl(urls++)); });
+    }
+    return std::make_shared<const ytcpp::Player>(scripts.front().id);
+}
+
+static void BenchFormatLists(const std::shared_ptr<const ytcpp::Player>& player, const json& response) {
+    constexpr size_t Iterations = 50;
+    size_t formatCount = response.at("streamingData").at("adaptiveFormats").size();
+    std::vector<std::string> responses;
+    for (size_t index = 0; index < Iterations * 3; ++index)
+        responses.push_back(WithNsig(response, fmt::format("list{}n", index)));
+
+    std::cout << "Format list (" << formatCount << " formats):\n";
+    size_t next = 0;
+    auto run = [&](const std::string& name, ytcpp::Format::List::Mode mode, bool resolveOne) {
+        uint64_t evaluations = ytcpp::Js::Interpreter::Evaluations();
+        Measure(name, Iterations, [&](size_t) {
+            ytcpp::Format::List list = ytcpp::Format::List::Parse("benchmark", responses[next++], player, mode);
+            if (resolveOne && !list.empty())
+                list.front()->url();
+        });
+        double perList = double(ytcpp::Js::Interpreter::Evaluations() - evaluations) / Iterations;
+        std::cout << "    " << perList << " JS evaluations per list\n";
+    };
+    run("eager", ytcpp::Format::List::Mode::Eager, false);
+    run("lazy", ytcpp::Format::List::Mode::Lazy, false);
+    run("lazy + one url", ytcpp::Format::List::Mode::Lazy, true);
+}
+
+static json TileRenderer(size_t index) {
+    return { {"tileRenderer", {
+        {"contentId", fmt::format("video{:06}", index)},
+        {"metadata", { {"tileMetadataRenderer", {
+            {"title", { {"simpleText", fmt::format("Video {}", index)} }},
+            {"lines", { { {"lineRenderer", { {"items", { { {"lineItemRenderer", { {"text", { {"simpleText", "Channel"} }} }} } }} }} } }},
+        }} }},
+        {"header", { {"tileHeaderRenderer", {
+            {"thumbnailOverlays", { { {"thumbnailOverlayTimeStatusRenderer", { {"text", { {"simpleText", "3:32"} }} }} } }},
+            {"thumbnail", { {"thumbnails", { { {"url", fmt::format("https://i.ytimg.com/vi/video{:06}/hqdefault.jpg", index)}, {"width", 480}, {"height", 360} } }} }},
+        }} }},
+    }} };
+}
+
+static std::vector<std::string> SyntheticPlaylistPages() {
+    std::vector<std::string> pages;
+    for (size_t page = 0; page < Synthetic::PlaylistPageCount; ++page) {
+        json renderer = { {"contents", json::array()} };
+        for (size_t index = 0; index < Synthetic::PlaylistPageSize; ++index)
+            renderer["contents"].push_back(TileRenderer(page * Synthetic::PlaylistPageSize + index));
+        if (page + 1 < Synthetic::PlaylistPageCount)
+            renderer["continuations"] = { { {"nextContinuationData", { {"continuation", fmt::format("page{}", page + 1)} }} } };
+
+        if (page) {
+            pages.push_back(json({ {"continuationContents", { {"playlistVideoListContinuation", std::move(renderer)} }} }).dump());
+            continue;
+        }
+
+        json byline = { {"lineItemRenderer", { {"text", { {"simpleText", "Channel"} }} }} };
+        json count = { {"lineItemRenderer", { {"text", { {"simpleText", std::to_string(Synthetic::PlaylistPageCount * Synthetic::PlaylistPageSize)} }} }} };
+        json twoColumnRenderer = {
+            {"leftColumn", { {"entityMetadataRenderer", {
+                {"title", { {"simpleText", "Benchmark playlist"} }},
+                {"bylines", { { {"lineRenderer", { {"items", { byline, byline, byline, count }} }} } }},
+            }} }},
+            {"rightColumn", { {"playlistVideoListRenderer", std::move(renderer)} }},
+        };
+        pages.push_back(json({ {"contents", { {"tvBrowseRenderer", { {"content", { {"tvSurfaceContentRenderer", { {"content", {
+            {"twoColumnRenderer", std::move(twoColumnRenderer)}
+        }} }} }} }} }} }).dump());
+    }
+    return pages;
+}
+
+static void BenchPlaylist() {
+    std::vector<std::string> pages = SyntheticPlaylistPages();
+    auto build = [&pages]() {
+        ytcpp::Playlist playlist = ytcpp::Playlist::Parse("PLbenchmark", pages.front());
+        for (size_t page = 1; page < pages.size(); ++page)
+            playlist.appendPage(pages[page]);
+        return playlist;
+    };
+
+    std::cout << "Playlist (" << pages.size() << " pages of " << Synthetic::PlaylistPageSize << " videos):\n";
+    Measure("append pages", 3, [&](size_t) { build(); });
+
+    ytcpp::Playlist playlist = build();
+    size_t titleBytes = 0;
+    Measure("iterate", 20, [&](size_t) {
+        for (ytcpp::Playlist::Iterator iterator = playlist.begin(); iterator; ++iterator)
+            titleBytes += iterator->title().size();
+    });
+    if (!titleBytes)
+        throw std::runtime_error("Playlist iteration found no videos");
+}
+
+int main(int argc, char** argv) {
+    try {
+        // Archived base.js files and recorded "player" responses are read from the corpus directory if given.
+        std::optional<fs::path> corpus;
+        if (argc > 1)
+            corpus = argv[1];
+
+        fs::path cacheDirectory = fs::temp_directory_path() / "ytcpp-bench";
+        fs::remove_all(cacheDirectory);
+        fs::create_directories(cacheDirectory);
+        ytcpp::Cache::SetDirectory(cacheDirectory.string());
+
+        BenchCipher();
+        std::shared_ptr<const ytcpp::Player> player = BenchPlayers(LoadPlayerScripts(corpus));
+        BenchFormatLists(player, LoadPlayerResponse(corpus));
+        BenchPlaylist();
+
+        fs::remove_all(cacheDirectory);
+        return 0;
+    }
+    catch (const ytcpp::YtError& error) {
+        std::cerr << "YouTube error occured!" << '\n';
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+    catch (const ytcpp::Error& error) {
+        std::cerr << "Fatal error occured!" << '\n';
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+    catch (const ytcpp::Js::Error& error) {
+        std::cerr << "JS error occured!" << '\n';
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+    catch (const std::exception& error) {
+        std::cerr << "Benchmark error occured!" << '\n';
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ytcpp/thumbnail.hpp"
+#include "ytcpp/video.hpp"
+
+namespace ytcpp {
+
+class Catalog {
+public:
+    class Entry {
+    private:
+        const char* m_record = nullptr;
+
+    private:
+        Entry(const char* record)
+            : m_record(record)
+        {}
+
+        friend class Catalog;
+
+    public:
+        std::string_view id() const;
+
+        std::string_view title() const;
+
+        std::string_view channel() const;
+
+        pt::time_duration duration() const;
+
+        bool isLivestream() const;
+
+        bool isUpcoming() const;
+
+        Thumbnail::List thumbnails() const;
+
+        Video video() const;
+    };
+
+private:
+    struct Mapping {
+        void* address = nullptr;
+        size_t size = 0;
+    };
+
+private:
+    static Video MakeVideo(const Entry& entry);
+
+private:
+    std::string m_dataPath;
+    std::string m_indexPath;
+    int m_dataFile = -1;
+    int m_indexFile = -1;
+    uint64_t m_dataSize = 0;
+    Mapping m_data;
+    std::vector<Mapping> m_retiredData;
+    Mapping m_index;
+    mutable std::shared_mutex m_mutex;
+
+public:
+    Catalog(const std::string& path);
+
+    Catalog(const Catalog&) = delete;
+
+    ~Catalog();
+
+public:
+    Catalog& operator=(const Catalog&) = delete;
+
+private:
+    void mapData(uint64_t size);
+
+    void createIndex(uint64_t capacity);
+
+    void growIndex();
+
+    void indexRecords(uint64_t offset);
+
+    void insert(uint64_t hash, uint64_t offset);
+
+    std::optional<uint64_t> locate(std::string_view id) const;
+
+public:
+    std::optional<Entry> find(std::string_view id) const;
+
+    bool contains(std::string_view id) const;
+
+    void put(const Video& video);
+
+    void sync();
+
+    size_t size() const;
+};
+
+} // namespace ytcpp
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ytcpp {
+
+class Cipher {
+public:
+    struct Operation {
+        enum class Type {
+            Reverse,
+            Splice,
+            Swap,
+        };
+
+        Type type = Type::Reverse;
+        int argument = 0;
+    };
+
+public:
+    static std::optional<Cipher> Compile(const std::string& functionCode, const std::string& objectCode);
+
+private:
+    std::vector<Operation> m_operations;
+
+public:
+    Cipher(std::vector<Operation> operations)
+        : m_operations(std::move(operations))
+    {}
+
+public:
+    std::string apply(std::string signature) const;
+
+public:
+    inline const std::vector<Operation>& operations() const {
+        return m_operations;
+    }
+};
+
+} // namespace ytcpp
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "ytcpp/core/executor.hpp"
+#include "ytcpp/core/lru_cache.hpp"
+#include "ytcpp/core/task.hpp"
+
+namespace ytcpp {
+
+class Cache;
+class Curl;
+class Innertube;
+class Logger;
+class Metrics;
+class NegativeCache;
+class Player;
+struct FormatListEntry;
+
+// Owns every piece of state the static facades (Curl, Innertube, Logger, Cache, NegativeCache, Metrics) operate on.
+// Facades resolve to the context made current on the calling thread, or to the default one.
+class Context {
+public:
+    using FormatListCache = LruCache<std::string, std::shared_ptr<FormatListEntry>>;
+
+    class Scope {
+    private:
+        Context* m_previous = nullptr;
+
+    public:
+        Scope(Context& context);
+
+        Scope(const Scope&) = delete;
+
+        ~Scope();
+
+    public:
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Outstanding work using the context, ~Context waits until none is left.
+    class Work {
+    private:
+        Context* m_context = nullptr;
+
+    public:
+        Work(Context& context);
+
+        Work(Work&& other) noexcept;
+
+        ~Work();
+
+    public:
+        Work& operator=(Work&& other) = delete;
+    };
+
+    // Result of work offloaded to the I/O pool, waited for by plain code or awaited by a coroutine
+    // without blocking its thread. Dropping it doesn't wait for the work, the context does.
+    template <typename T>
+    class Pending {
+    private:
+        struct State {
+            std::mutex mutex;
+            std::condition_variable completed;
+            bool done = false;
+            std::optional<T> value;
+            std::exception_ptr error;
+            std::coroutine_handle<> waiter;
+        };
+
+        struct Awaiter {
+            std::shared_ptr<State> state;
+
+            inline bool await_ready() const {
+                std::lock_guard lock(state->mutex);
+                return state->done;
+            }
+
+            inline bool await_suspend(std::coroutine_handle<> handle) const {
+                std::lock_guard lock(state->mutex);
+                if (state->done)
+                    return false;
+                state->waiter = handle;
+                return true;
+            }
+
+            inline T await_resume() const {
+                if (state->error)
+                    std::rethrow_exception(state->error);
+                return *state->value;
+            }
+        };
+
+    private:
+        std::shared_ptr<State> m_state;
+
+        friend class Context;
+
+    public:
+        inline bool valid() const {
+            return static_cast<bool>(m_state);
+        }
+
+        inline const T& get() const {
+            std::unique_lock lock(m_state->mutex);
+            m_state->completed.wait(lock, [this]() {
+                return m_state->done;
+            });
+            if (m_state->error)
+                std::rethrow_exception(m_state->error);
+            return *m_state->value;
+        }
+
+        inline Awaiter operator co_await() const {
+            return { m_state };
+        }
+    };
+
+public:
+    static constexpr size_t FormatListCacheCapacity = 1024;
+    static constexpr size_t IoThreadCount = 8;
+
+private:
+    std::unique_ptr<Logger> m_logger;
+    std::unique_ptr<Metrics> m_metrics;
+    std::unique_ptr<Curl> m_curl;
+    std::unique_ptr<Cache> m_cache;
+    std::unique_ptr<Innertube> m_innertube;
+    std::unique_ptr<NegativeCache> m_negativeCache;
+    std::mutex m_playersMutex;
+    std::map<std::string, std::shared_future<std::shared_ptr<const Player>>> m_players;
+    FormatListCache m_formatLists;
+    std::atomic<std::shared_ptr<Executor>> m_executor;
+    std::mutex m_workMutex;
+    std::condition_variable m_workDone;
+    size_t m_work = 0;
+    std::once_flag m_ioExecutorCreated;
+    std::unique_ptr<ThreadPool> m_ioExecutor;
+
+    friend class Cache;
+    friend class Curl;
+    friend class Innertube;
+    friend class Logger;
+    friend class Metrics;
+    friend class NegativeCache;
+
+public:
+    Context();
+
+    Context(const Context&) = delete;
+
+    ~Context();
+
+public:
+    Context& operator=(const Context&) = delete;
+
+public:
+    static Context& Default();
+
+    static Context& Current();
+
+    static std::shared_ptr<Executor> DefaultExecutor();
+
+public:
+    // Builds the player on first use, concurrent callers asking for the same one wait for that build only.
+    std::shared_ptr<const Player> player(const std::string& playerId);
+
+    std::shared_ptr<Executor> executor() const;
+
+    void setExecutor(std::shared_ptr<Executor> executor);
+
+    // Blocking requests run on the context's bounded I/O pool, their results are parsed on the executor.
+    template <typename Fetch, typename Parse>
+    auto async(Fetch fetch, Parse parse) {
+        using Result = std::invoke_result_t<Parse, std::invoke_result_t<Fetch>>;
+        auto promise = std::make_shared<std::promise<Result>>();
+        std::future<Result> future = promise->get_future();
+        ioExecutor().post([this, promise, fetch = std::move(fetch), parse = std::move(parse), work = Work(*this)]() mutable {
+            try {
+                Scope scope(*this);
+                executor()->post([this, promise, parse = std::move(parse), fetched = fetch(), work = std::move(work)]() mutable {
+                    try {
+                        Scope scope(*this);
+                        promise->set_value(parse(std::move(fetched)));
+                    }
+                    catch (...) {
+                        promise->set_exception(std::current_exception());
+                    }
+                });
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        return future;
+    }
+
+    // Runs blocking work on the I/O pool, an awaiting coroutine is resumed on the executor.
+    template <typename Fetch>
+    Pending<std::invoke_result_t<Fetch>> offload(Fetch fetch) {
+        using Result = std::invoke_result_t<Fetch>;
+        Pending<Result> pending;
+        pending.m_state = std::make_shared<typename Pending<Result>::State>();
+        ioExecutor().post([this, state = pending.m_state, fetch = std::move(fetch), work = Work(*this)]() mutable {
+            std::optional<Result> value;
+            std::exception_ptr error;
+            try {
+                Scope scope(*this);
+                value.emplace(fetch());
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            std::coroutine_handle<> waiter;
+            {
+                std::lock_guard lock(state->mutex);
+                state->value = std::move(value);
+                state->error = error;
+                state->done = true;
+                waiter = std::exchange(state->waiter, {});
+                state->completed.notify_all();
+            }
+            if (waiter) {
+                executor()->post([this, waiter, work = std::move(work)]() {
+                    Scope scope(*this);
+                    waiter.resume();
+                });
+            }
+        });
+        return pending;
+    }
+
+    // Starts the task on the executor, the returned future is ready once the task finishes.
+    template <typename T>
+    std::future<T> spawn(Task<T> task) {
+        auto promise = std::make_shared<std::promise<T>>();
+        std::future<T> future = promise->get_future();
+        executor()->post([this, promise, task = std::move(task), work = Work(*this)]() mutable {
+            Scope scope(*this);
+            Drive(std::move(task), std::move(promise), std::move(work));
+        });
+        return future;
+    }
+
+private:
+    Executor& ioExecutor();
+
+    template <typename T>
+    static Detail::Detached Drive(Task<T> task, std::shared_ptr<std::promise<T>> promise, Work work) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(task);
+                promise->set_value();
+            }
+            else {
+                promise->set_value(co_await std::move(task));
+            }
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    }
+
+public:
+    inline FormatListCache& formatLists() {
+        return m_formatLists;
+    }
+};
+
+} // namespace ytcpp
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ytcpp {
+
+class Arena {
+public:
+    struct Stats {
+        size_t currentBytes = 0;
+        size_t peakBytes = 0;
+        size_t reservedBytes = 0;
+        uint64_t allocations = 0;
+        uint64_t failedAllocations = 0;
+    };
+
+private:
+    static constexpr size_t ChunkSize = 64 * 1024;
+    static constexpr size_t MinClassSize = 16;
+    static constexpr size_t ClassCount = 8;
+
+    struct alignas(16) Header {
+        size_t size;
+        size_t sizeClass;
+    };
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+private:
+    size_t m_limit = 0;
+    std::vector<void*> m_chunks;
+    char* m_cursor = nullptr;
+    char* m_chunkEnd = nullptr;
+    std::array<FreeBlock*, ClassCount> m_freeLists = {};
+    Stats m_stats;
+
+public:
+    Arena(size_t limit = 0)
+        : m_limit(limit)
+    {}
+
+    Arena(const Arena& other) = delete;
+
+    ~Arena();
+
+public:
+    Arena& operator=(const Arena& other) = delete;
+
+private:
+    static size_t SizeClass(size_t size);
+
+    static inline size_t ClassSize(size_t sizeClass) {
+        return MinClassSize << sizeClass;
+    }
+
+    void* allocateSmall(size_t sizeClass);
+
+public:
+    void* allocate(size_t size);
+
+    void* reallocate(void* pointer, size_t size);
+
+    void deallocate(void* pointer);
+
+public:
+    inline size_t limit() const {
+        return m_limit;
+    }
+
+    inline const Stats& stats() const {
+        return m_stats;
+    }
+};
+
+} // namespace ytcpp
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace ytcpp {
+
+// Blocking FIFO of limited capacity: producers wait while it's full, consumers while it's empty.
+template <typename T>
+class BoundedQueue {
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::deque<T> m_items;
+    size_t m_capacity;
+    bool m_closed = false;
+
+public:
+    BoundedQueue(size_t capacity)
+        : m_capacity(std::max<size_t>(capacity, 1))
+    {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+
+public:
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+public:
+    // Returns false if the queue was closed before the item could be queued.
+    bool push(T item) {
+        std::unique_lock lock(m_mutex);
+        m_notFull.wait(lock, [this]() {
+            return m_closed || m_items.size() < m_capacity;
+        });
+        if (m_closed)
+            return false;
+
+        m_items.push_back(std::move(item));
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    // Returns std::nullopt once the queue is closed and drained.
+    std::optional<T> pop() {
+        std::unique_lock lock(m_mutex);
+        m_notEmpty.wait(lock, [this]() {
+            return m_closed || !m_items.empty();
+        });
+        if (m_items.empty())
+            return std::nullopt;
+
+        std::optional<T> item(std::move(m_items.front()));
+        m_items.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return item;
+    }
+
+    // Queued items can still be popped, further pushes fail.
+    void close() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_closed = true;
+        }
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+
+public:
+    inline size_t size() const {
+        std::lock_guard lock(m_mutex);
+        return m_items.size();
+    }
+
+    inline size_t capacity() const {
+        return m_capacity;
+    }
+
+    inline bool closed() const {
+        std::lock_guard lock(m_mutex);
+        return m_closed;
+    }
+};
+
+} // namespace ytcpp
@@ -1,44 +1,59 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 
 namespace ytcpp {
 
 class Cache {
 public:
-    struct Auth {
-        bool authorized = false;
-        std::string accessToken;
-        std::string accessTokenType;
-        int expiresAt = 0;
-        std::string refreshToken;
+    using Value = std::shared_ptr<const std::string>;
+    using Updater = std::function<std::optional<std::string>(const Value& current)>;
 
-        bool operator==(const Auth& other) const = default;
-    };
+private:
+    using Snapshot = std::unordered_map<std::string, Value>;
+
+    static constexpr size_t KeyMutexCount = 16;
 
 private:
-    static std::mutex Mutex;
-    std::lock_guard<std::mutex> m_lock;
-    Auth m_auth;
-    Auth m_originalAuth;
+    std::atomic<std::shared_ptr<const Snapshot>> m_snapshot;
+    std::mutex m_publishMutex;
+    std::mutex m_keyMutexes[KeyMutexCount];
+    std::string m_directory = ".ytcpp_cache";
 
-public:
+private:
     Cache();
 
-    ~Cache();
+    static Cache& Instance();
+
+    friend class Context;
 
 private:
-    void save();
+    static std::string Path(const std::string& key);
+
+    static Value Load(const std::string& key);
+
+    static void Store(const std::string& key, const std::string& value);
+
+    static void Publish(const std::string& key, Value value);
 
 public:
-    inline const Auth& auth() const {
-        return m_auth;
-    }
+    static void SetDirectory(const std::string& directory);
+
+    static std::string Directory();
+
+    static Value Read(const std::string& key);
+
+    static void Write(const std::string& key, const std::string& value);
+
+    static Value Update(const std::string& key, const Updater& updater);
 
-    inline Auth& auth() {
-        return m_auth;
-    }
+    static void Erase(const std::string& key);
 };
 
 } // namespace ytcpp
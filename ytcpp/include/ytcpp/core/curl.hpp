@@ -1,11 +1,18 @@
 #pragma once
 
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <stop_token>
 #include <string>
 #include <vector>
 
 namespace ytcpp {
 
+class Context;
+
 class Curl {
 public:
     using Headers = std::vector<std::string>;
@@ -16,21 +23,71 @@ public:
         std::string data;
     };
 
+    // Awaitable request performed by the context's non-blocking engine; the awaiting
+    // coroutine is resumed on the context executor.
+    class Operation {
+    private:
+        struct State;
+
+    private:
+        std::shared_ptr<State> m_state;
+
+    public:
+        Operation(const std::string& url, const Headers& headers, bool noBody, const std::string& data, std::stop_token stopToken);
+
+    public:
+        inline bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle);
+
+        Response await_resume();
+    };
+
+private:
+    using Completion = std::move_only_function<void(Response&& response, std::exception_ptr error)>;
+
+    class Engine;
+
+private:
+    static constexpr size_t MaxIdleHandles = 16;
+
 private:
     std::mutex m_mutex;
     std::string m_proxyUrl;
+    std::vector<void*> m_idleHandles;
+    std::unique_ptr<Engine> m_engine;
+    bool m_closed = false;
 
 private:
-    Curl() = default;
+    Curl();
 
-    static inline Curl& Instance() {
-        static Curl instance;
-        return instance;
-    }
+    static Curl& Instance();
+
+    friend class Context;
+
+public:
+    Curl(const Curl&) = delete;
+
+    ~Curl();
+
+public:
+    Curl& operator=(const Curl&) = delete;
 
 private:
     static Response Request(const std::string& url, const std::string& proxyUrl, const Headers& headers, bool noBody = false, const std::string& data = {});
 
+private:
+    void* acquireHandle();
+
+    void releaseHandle(void* handle);
+
+    Engine& engine();
+
+    // Fails asynchronous requests in flight and refuses new ones, blocking requests are unaffected.
+    void close();
+
 public:
     static inline void SetProxyUrl(const std::string& url) {
         std::lock_guard lock(Instance().m_mutex);
@@ -56,6 +113,14 @@ public:
         std::string proxyUrl = GetProxyUrl();
         return Request(url, proxyUrl, headers, false, data);
     }
+
+    static inline Operation AsyncGet(const std::string& url, const Headers& headers = {}, std::stop_token stopToken = {}) {
+        return { url, headers, false, {}, std::move(stopToken) };
+    }
+
+    static inline Operation AsyncPost(const std::string& url, const Headers& headers, const std::string& data, std::stop_token stopToken = {}) {
+        return { url, headers, false, data, std::move(stopToken) };
+    }
 };
 
 } // namespace ytcpp
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ytcpp {
+
+class Executor {
+public:
+    using Task = std::move_only_function<void()>;
+
+public:
+    virtual ~Executor() = default;
+
+public:
+    virtual void post(Task task) = 0;
+
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function&& function) {
+        std::packaged_task<std::invoke_result_t<Function>()> task(std::forward<Function>(function));
+        auto future = task.get_future();
+        post(std::move(task));
+        return future;
+    }
+};
+
+class ThreadPool : public Executor {
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+private:
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<size_t> m_pending = 0;
+    std::atomic<size_t> m_nextQueue = 0;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+
+public:
+    ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+public:
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+private:
+    bool pop(size_t index, Task& task);
+
+    void run(size_t index);
+
+public:
+    void post(Task task) override;
+
+public:
+    inline size_t threadCount() const {
+        return m_threads.size();
+    }
+};
+
+} // namespace ytcpp
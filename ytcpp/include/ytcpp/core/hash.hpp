@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace ytcpp {
+
+namespace Hash {
+    // 64-bit FNV-1a, stable across builds and platforms.
+    inline uint64_t Fnv1a(std::string_view data) {
+        uint64_t hash = 14695981039346656037ull;
+        for (char character : data) {
+            hash ^= static_cast<uint8_t>(character);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+} // namespace ytcpp
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <stdexcept>
-
-#include <duktape.h>
+#include <vector>
 
 #include <fmt/format.h>
 
+#include "ytcpp/core/arena.hpp"
+
 namespace ytcpp {
 
 namespace Js {
@@ -29,23 +33,118 @@ namespace Js {
         }
     };
 
+    class Engine {
+    public:
+        using Instance = std::unique_ptr<Engine>;
+
+    public:
+        static std::string Version();
+
+        static Instance Create(size_t maxBytes);
+
+    public:
+        Engine() = default;
+
+        // Heaps point into engine-owned allocators and can't be moved out of them.
+        Engine(const Engine& other) = delete;
+
+        virtual ~Engine() = default;
+
+    public:
+        Engine& operator=(const Engine& other) = delete;
+
+    public:
+        virtual std::string execute(const std::string& code) = 0;
+
+        virtual std::string compile(const std::string& code) = 0;
+
+        virtual void load(const std::string& bytecode) = 0;
+
+        virtual Arena::Stats memory() const = 0;
+    };
+
     class Interpreter {
+    public:
+        struct Limits {
+            size_t maxBytes = 0;
+            size_t resetBytes = 0;
+        };
+
+        struct Statistics {
+            Arena::Stats memory;
+            uint64_t resets = 0;
+        };
+
     private:
-        std::unique_ptr<duk_context, decltype(&duk_destroy_heap)> m_context;
+        static std::atomic<uint64_t> EvaluationCount;
+
+        static inline std::mutex& LimitsMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        static inline Limits& CurrentDefaultLimits() {
+            static Limits limits;
+            return limits;
+        }
 
     public:
-        Interpreter();
+        static inline uint64_t Evaluations() {
+            return EvaluationCount.load(std::memory_order_relaxed);
+        }
+
+        static inline std::string EngineVersion() {
+            return Engine::Version();
+        }
+
+        // Engine version plus the bytecode layout of this build, bytecode is only portable between equal fingerprints.
+        static const std::string& EngineFingerprint();
+
+        static inline void SetDefaultLimits(const Limits& limits) {
+            std::lock_guard lock(LimitsMutex());
+            CurrentDefaultLimits() = limits;
+        }
+
+        static inline Limits DefaultLimits() {
+            std::lock_guard lock(LimitsMutex());
+            return CurrentDefaultLimits();
+        }
+
+    private:
+        Limits m_limits;
+        Engine::Instance m_engine;
+        std::vector<std::string> m_prelude;
+        uint64_t m_resets = 0;
+
+    public:
+        Interpreter(const Limits& limits = DefaultLimits());
 
         Interpreter(Interpreter&& other) = default;
 
     public:
-        Interpreter& operator=(Interpreter&& other) = default;
+        Interpreter& operator=(Interpreter&& other) noexcept;
 
     public:
         std::string execute(const std::string& code);
 
+        std::string compile(const std::string& code);
+
+        void load(const std::string& bytecode);
+
         void reset();
 
+    private:
+        void checkMemory();
+
+    public:
+        inline const Limits& limits() const {
+            return m_limits;
+        }
+
+        inline Statistics statistics() const {
+            return { m_engine ? m_engine->memory() : Arena::Stats(), m_resets };
+        }
+
     public:
         template <typename... Arguments>
         inline std::string execute(fmt::format_string<Arguments...> code, Arguments&&... arguments) {
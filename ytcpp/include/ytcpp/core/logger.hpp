@@ -13,10 +13,9 @@ private:
         : m_logger("ytcpp", {})
     {}
 
-    static inline Logger& Instance() {
-        static Logger instance;
-        return instance;
-    }
+    static Logger& Instance();
+
+    friend class Context;
 
 public:
     static inline std::vector<spdlog::sink_ptr>& Sinks() {
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace ytcpp {
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+        size_t size = 0;
+        size_t cost = 0;
+
+        inline double hitRate() const {
+            uint64_t lookups = hits + misses;
+            return lookups ? static_cast<double>(hits) / lookups : 0.0;
+        }
+    };
+
+private:
+    struct Entry {
+        Key key;
+        Value value;
+        size_t cost = 1;
+        Clock::time_point expiresAt = Clock::time_point::max();
+    };
+
+    using Entries = std::list<Entry>;
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        Entries entries;
+        std::unordered_map<Key, typename Entries::iterator, Hash> index;
+        size_t cost = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+    };
+
+private:
+    Hash m_hash;
+    size_t m_shardCount;
+    size_t m_shardCapacity;
+    std::unique_ptr<Shard[]> m_shards;
+
+public:
+    LruCache(size_t capacity, size_t shardCount = 16)
+        : m_shardCount(std::max<size_t>(shardCount, 1))
+        , m_shardCapacity(std::max<size_t>((capacity + m_shardCount - 1) / m_shardCount, 1))
+        , m_shards(std::make_unique<Shard[]>(m_shardCount))
+    {}
+
+private:
+    inline Shard& shard(const Key& key) {
+        return m_shards[m_hash(key) % m_shardCount];
+    }
+
+    static inline void Remove(Shard& shard, typename Entries::iterator entry) {
+        shard.cost -= entry->cost;
+        shard.index.erase(entry->key);
+        shard.entries.erase(entry);
+    }
+
+public:
+    std::optional<Value> get(const Key& key) {
+        Shard& shard = this->shard(key);
+        std::lock_guard lock(shard.mutex);
+        auto entry = shard.index.find(key);
+        if (entry == shard.index.end()) {
+            ++shard.misses;
+            return std::nullopt;
+        }
+
+        if (entry->second->expiresAt <= Clock::now()) {
+            Remove(shard, entry->second);
+            ++shard.expirations;
+            ++shard.misses;
+            return std::nullopt;
+        }
+
+        ++shard.hits;
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry->second);
+        return entry->second->value;
+    }
+
+    void put(const Key& key, Value value, size_t cost = 1, Clock::duration ttl = Clock::duration::zero()) {
+        Shard& shard = this->shard(key);
+        std::lock_guard lock(shard.mutex);
+        auto entry = shard.index.find(key);
+        if (entry != shard.index.end())
+            Remove(shard, entry->second);
+
+        // Entries that can never fit would only flush the whole shard.
+        if (cost > m_shardCapacity)
+            return;
+
+        Clock::time_point expiresAt = ttl > Clock::duration::zero() ? Clock::now() + ttl : Clock::time_point::max();
+        shard.entries.push_front({ key, std::move(value), cost, expiresAt });
+        shard.index.emplace(key, shard.entries.begin());
+        shard.cost += cost;
+        while (shard.cost > m_shardCapacity) {
+            Remove(shard, std::prev(shard.entries.end()));
+            ++shard.evictions;
+        }
+    }
+
+    bool erase(const Key& key) {
+        Shard& shard = this->shard(key);
+        std::lock_guard lock(shard.mutex);
+        auto entry = shard.index.find(key);
+        if (entry == shard.index.end())
+            return false;
+
+        Remove(shard, entry->second);
+        return true;
+    }
+
+    template <typename Predicate>
+    size_t eraseIf(Predicate predicate) {
+        size_t erased = 0;
+        for (size_t index = 0; index < m_shardCount; ++index) {
+            Shard& shard = m_shards[index];
+            std::lock_guard lock(shard.mutex);
+            for (auto entry = shard.entries.begin(); entry != shard.entries.end();) {
+                auto current = entry++;
+                if (predicate(current->key, current->value)) {
+                    Remove(shard, current);
+                    ++erased;
+                }
+            }
+        }
+        return erased;
+    }
+
+    void clear() {
+        for (size_t index = 0; index < m_shardCount; ++index) {
+            std::lock_guard lock(m_shards[index].mutex);
+            m_shards[index].entries.clear();
+            m_shards[index].index.clear();
+            m_shards[index].cost = 0;
+        }
+    }
+
+    Stats stats() const {
+        Stats stats;
+        for (size_t index = 0; index < m_shardCount; ++index) {
+            std::lock_guard lock(m_shards[index].mutex);
+            stats.hits += m_shards[index].hits;
+            stats.misses += m_shards[index].misses;
+            stats.evictions += m_shards[index].evictions;
+            stats.expirations += m_shards[index].expirations;
+            stats.size += m_shards[index].entries.size();
+            stats.cost += m_shards[index].cost;
+        }
+        return stats;
+    }
+};
+
+} // namespace ytcpp
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace ytcpp {
+
+// Lossy fixed-size hash table in POSIX shared memory, shared by every process opening the same name.
+// Slots are guarded by sequence locks: readers never block and a busy slot is a miss or a skipped write.
+class SharedTable {
+public:
+    static constexpr size_t DefaultSlotCount = 16384;
+    static constexpr size_t MaxKeySize = 240;
+    static constexpr size_t MaxValueSize = 256;
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t writes = 0;
+        size_t skippedWrites = 0;
+    };
+
+private:
+    struct Header;
+    struct Slot;
+
+private:
+    std::string m_name;
+    Header* m_header = nullptr;
+    Slot* m_slots = nullptr;
+    size_t m_size = 0;
+    uint64_t m_mask = 0;
+    mutable std::atomic<size_t> m_hits = 0;
+    mutable std::atomic<size_t> m_misses = 0;
+    std::atomic<size_t> m_writes = 0;
+    std::atomic<size_t> m_skippedWrites = 0;
+
+public:
+    SharedTable(const std::string& name, size_t slotCount = DefaultSlotCount);
+
+    SharedTable(const SharedTable&) = delete;
+
+    ~SharedTable();
+
+public:
+    SharedTable& operator=(const SharedTable&) = delete;
+
+public:
+    static void Unlink(const std::string& name);
+
+public:
+    std::optional<std::string> get(std::string_view key) const;
+
+    bool put(std::string_view key, std::string_view value);
+
+    Stats stats() const;
+
+public:
+    inline const std::string& name() const {
+        return m_name;
+    }
+
+    inline size_t slotCount() const {
+        return m_mask + 1;
+    }
+};
+
+} // namespace ytcpp
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace ytcpp {
+
+template <typename T = void>
+class Task;
+
+namespace Detail {
+    class TaskPromiseBase {
+    private:
+        struct FinalAwaiter {
+            inline bool await_ready() const noexcept {
+                return false;
+            }
+
+            template <typename Promise>
+            inline std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+                std::coroutine_handle<> continuation = handle.promise().m_continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            inline void await_resume() const noexcept {}
+        };
+
+    private:
+        std::coroutine_handle<> m_continuation;
+
+        template <typename T>
+        friend class ytcpp::Task;
+
+    protected:
+        std::exception_ptr m_error;
+
+    public:
+        inline std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        inline FinalAwaiter final_suspend() const noexcept {
+            return {};
+        }
+
+        inline void unhandled_exception() noexcept {
+            m_error = std::current_exception();
+        }
+    };
+
+    template <typename T>
+    class TaskPromise : public TaskPromiseBase {
+    private:
+        std::optional<T> m_value;
+
+    public:
+        Task<T> get_return_object() noexcept;
+
+        inline void return_value(T value) {
+            m_value.emplace(std::move(value));
+        }
+
+        inline T result() {
+            if (m_error)
+                std::rethrow_exception(m_error);
+            return std::move(*m_value);
+        }
+    };
+
+    template <>
+    class TaskPromise<void> : public TaskPromiseBase {
+    public:
+        Task<void> get_return_object() noexcept;
+
+        inline void return_void() const noexcept {}
+
+        inline void result() {
+            if (m_error)
+                std::rethrow_exception(m_error);
+        }
+    };
+}
+
+// Lazily started coroutine: the body runs once the task is awaited and the awaiting
+// coroutine resumes on whichever thread the task finishes.
+template <typename T>
+class Task {
+public:
+    using promise_type = Detail::TaskPromise<T>;
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+
+public:
+    Task() = default;
+
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : m_handle(handle)
+    {}
+
+    Task(Task&& other) noexcept
+        : m_handle(std::exchange(other.m_handle, {}))
+    {}
+
+    Task(const Task&) = delete;
+
+    ~Task() {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+public:
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    Task& operator=(const Task&) = delete;
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            inline bool await_ready() const noexcept {
+                return false;
+            }
+
+            inline std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) const noexcept {
+                handle.promise().m_continuation = continuation;
+                return handle;
+            }
+
+            inline T await_resume() const {
+                return handle.promise().result();
+            }
+        };
+        return Awaiter{ m_handle };
+    }
+
+public:
+    inline bool valid() const noexcept {
+        return static_cast<bool>(m_handle);
+    }
+};
+
+namespace Detail {
+    // Eagerly started coroutine that frees itself on completion, used to drive a task from plain code.
+    struct Detached {
+        struct promise_type {
+            inline Detached get_return_object() const noexcept {
+                return {};
+            }
+
+            inline std::suspend_never initial_suspend() const noexcept {
+                return {};
+            }
+
+            inline std::suspend_never final_suspend() const noexcept {
+                return {};
+            }
+
+            inline void return_void() const noexcept {}
+
+            inline void unhandled_exception() const noexcept {
+                std::terminate();
+            }
+        };
+    };
+
+    template <typename T>
+    inline Task<T> TaskPromise<T>::get_return_object() noexcept {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+}
+
+} // namespace ytcpp
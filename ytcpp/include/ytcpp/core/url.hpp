@@ -0,0 +1,40 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ytcpp {
+
+namespace Url {
+    std::string Decode(std::string_view string);
+
+    std::string Encode(std::string_view string);
+
+    class Query {
+    public:
+        using Parameter = std::pair<std::string_view, std::string_view>;
+
+    private:
+        std::vector<Parameter> m_parameters;
+
+    public:
+        Query(std::string_view urlOrQuery);
+
+    public:
+        std::optional<std::string_view> find(std::string_view name) const;
+
+        std::optional<std::string> get(std::string_view name) const;
+
+    public:
+        inline const std::vector<Parameter>& parameters() const {
+            return m_parameters;
+        }
+    };
+
+    std::string SetParameter(std::string_view url, std::string_view name, std::string_view value);
+}
+
+} // namespace ytcpp
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
 
 #include <boost/date_time.hpp>
 namespace dt = boost::gregorian;
@@ -11,17 +17,57 @@ namespace pt = boost::posix_time;
 #include <nlohmann/json.hpp>
 using nlohmann::json;
 
+#include "ytcpp/core/curl.hpp"
+#include "ytcpp/core/task.hpp"
+#include "ytcpp/context.hpp"
 #include "ytcpp/dimensions.hpp"
 
 namespace ytcpp {
 
+class Player;
+
 class Format {
 public:
     using Instance = std::unique_ptr<Format>;
 
     class List : public std::vector<Instance> {
     public:
-        List(const std::string& videoIdOrUrl);
+        using Clock = std::chrono::system_clock;
+        using Shared = std::shared_ptr<const List>;
+
+        enum class Mode {
+            Eager,
+            Lazy,
+        };
+
+    public:
+        static Shared Cached(const std::string& videoIdOrUrl, Context& context = Context::Current());
+
+        static std::future<List> Async(const std::string& videoIdOrUrl, Mode mode = Mode::Eager, Context& context = Context::Current());
+
+        static Task<List> Fetch(std::string videoIdOrUrl, Mode mode = Mode::Eager, std::stop_token stopToken = {}, Context& context = Context::Current());
+
+        static void ClearCache(Context& context = Context::Current());
+
+        // Builds the list from a "player" response obtained elsewhere, such as a recorded one.
+        static List Parse(const std::string& videoId, const std::string& response, const std::shared_ptr<const Player>& player, Mode mode = Mode::Eager);
+
+    private:
+        std::optional<Clock::time_point> m_expiresAt;
+
+    private:
+        List() = default;
+
+    public:
+        List(const std::string& videoIdOrUrl, Mode mode = Mode::Eager, Context& context = Context::Current());
+
+    private:
+        void parse(const std::string& videoId, const Curl::Response& response, const std::shared_ptr<const Player>& player, Mode mode);
+
+    public:
+        inline const std::optional<Clock::time_point>& expiresAt() const {
+            return m_expiresAt;
+        }
     };
 
     enum class Type {
@@ -37,7 +83,10 @@ private:
     uint64_t m_bitrate = 0;
     std::string m_format;
     std::string m_codec;
-    std::string m_url;
+    mutable std::string m_url;
+    mutable std::once_flag m_urlPrepared;
+    // Player deciphering a lazy format, shared so the format may outlive its context.
+    std::shared_ptr<const Player> m_player;
     std::optional<pt::time_duration> m_duration;
 
 public:
@@ -70,9 +119,7 @@ public:
         return m_codec;
     }
 
-    inline const std::string& url() const {
-        return m_url;
-    }
+    const std::string& url() const;
 
     inline const std::optional<pt::time_duration>& duration() const {
         return m_duration;
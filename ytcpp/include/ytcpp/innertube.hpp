@@ -1,43 +1,113 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <string>
 #include <mutex>
+#include <optional>
+#include <stop_token>
+#include <unordered_map>
+#include <utility>
 
 #include "ytcpp/core/cache.hpp"
 #include "ytcpp/core/curl.hpp"
+#include "ytcpp/core/lru_cache.hpp"
+#include "ytcpp/core/task.hpp"
+#include "ytcpp/context.hpp"
 #include "ytcpp/client.hpp"
+#include "ytcpp/negative_cache.hpp"
 
 namespace ytcpp {
 
 class Innertube {
+public:
+    struct Auth {
+        bool authorized = false;
+        std::string accessToken;
+        std::string accessTokenType;
+        int expiresAt = 0;
+        std::string refreshToken;
+
+        bool operator==(const Auth& other) const = default;
+    };
+
+    using ResponseCache = LruCache<std::string, Curl::Response>;
+    using ResponseTtls = std::unordered_map<std::string, std::chrono::seconds>;
+
+private:
+    // Read by every call without locking, replaced as a whole by the setters.
+    struct Settings {
+        bool authEnabled = false;
+        std::shared_ptr<ResponseCache> responseCache;
+        ResponseTtls responseTtls;
+    };
+
+    struct PreparedCall {
+        std::string url;
+        Curl::Headers headers;
+        std::string data;
+        std::shared_ptr<ResponseCache> responseCache;
+        std::chrono::seconds ttl{};
+        std::string key;
+    };
+
 private:
     std::mutex m_mutex;
-    bool m_authEnabled = false;
+    std::mutex m_authMutex;
+    std::atomic<std::shared_ptr<const Settings>> m_settings = std::make_shared<const Settings>();
 
 private:
     Innertube() = default;
 
-    static inline Innertube& Instance() {
-        static Innertube instance;
-        return instance;
-    }
+    static Innertube& Instance();
+
+    friend class Context;
 
 private:
-    static Cache::Auth UpdateAuth();
+    static Auth UpdateAuth();
+
+    static inline std::shared_ptr<const Settings> CurrentSettings() {
+        return Instance().m_settings.load(std::memory_order_acquire);
+    }
+
+    static void UpdateSettings(const std::function<void(Settings& settings)>& update);
+
+    static std::pair<std::shared_ptr<ResponseCache>, std::chrono::seconds> ResponseCacheFor(const Settings& settings, const std::string& endpoint);
+
+    static PreparedCall PrepareCall(Client::Type client, const std::string& endpoint, const json& additionalData);
+
+    static std::optional<Curl::Response> CachedResponse(const PreparedCall& call);
+
+    static void StoreResponse(const PreparedCall& call, const Curl::Response& response);
 
 public:
     static Curl::Response CallApi(Client::Type client, const std::string& endpoint, const json& additionalData);
 
+    static Task<Curl::Response> CallApiAsync(Client::Type client, std::string endpoint, json additionalData, std::stop_token stopToken = {}, Context& context = Context::Current());
+
+    static ResponseTtls DefaultResponseTtls();
+
+    static void EnableResponseCache(size_t maxBytes, const ResponseTtls& ttls = DefaultResponseTtls());
+
+    static void DisableResponseCache();
+
+    static ResponseCache::Stats ResponseCacheStats();
+
 public:
     static inline void AuthEnabled(bool enabled) {
-        std::lock_guard lock(Instance().m_mutex);
-        Instance().m_authEnabled = enabled;
-        if (enabled) UpdateAuth();
+        UpdateSettings([enabled](Settings& settings) {
+            settings.authEnabled = enabled;
+        });
+        if (enabled) {
+            UpdateAuth();
+            NegativeCache::Invalidate(YtError::Type::LoginRequired);
+        }
     }
 
     static inline bool AuthEnabled() {
-        std::lock_guard lock(Instance().m_mutex);
-        return Instance().m_authEnabled;
+        return CurrentSettings()->authEnabled;
     }
 };
 
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ytcpp {
+
+class Metrics {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    class Counter {
+    private:
+        std::atomic<uint64_t> m_value = 0;
+
+    public:
+        inline void add(uint64_t amount = 1) {
+            m_value.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        inline uint64_t value() const {
+            return m_value.load(std::memory_order_relaxed);
+        }
+    };
+
+    // Latencies in microseconds over power of two buckets from 64 us to ~268 s, the last bucket is unbounded.
+    class Histogram {
+    public:
+        static constexpr size_t BucketCount = 24;
+        static constexpr uint64_t FirstBound = 64;
+
+    public:
+        static constexpr size_t BucketIndex(uint64_t us) {
+            if (us <= FirstBound)
+                return 0;
+            return std::min<size_t>(std::bit_width((us - 1) / FirstBound), BucketCount - 1);
+        }
+
+        static constexpr uint64_t BucketBound(size_t index) {
+            return FirstBound << index;
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, BucketCount> m_buckets = {};
+        std::atomic<uint64_t> m_sum = 0;
+
+    public:
+        inline void observe(uint64_t us) {
+            m_buckets[BucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(us, std::memory_order_relaxed);
+        }
+
+        inline std::vector<uint64_t> buckets() const {
+            std::vector<uint64_t> buckets(BucketCount);
+            for (size_t index = 0; index < BucketCount; ++index)
+                buckets[index] = m_buckets[index].load(std::memory_order_relaxed);
+            return buckets;
+        }
+
+        inline uint64_t sum() const {
+            return m_sum.load(std::memory_order_relaxed);
+        }
+    };
+
+    struct Sample {
+        enum class Type {
+            Counter,
+            Gauge,
+            Histogram,
+        };
+
+        std::string name;
+        Labels labels;
+        Type type = Type::Counter;
+        // Counter or gauge value, observation count of histograms.
+        uint64_t value = 0;
+        std::vector<uint64_t> buckets;
+        uint64_t sum = 0;
+
+        // Upper bound of the bucket holding the quantile, in seconds.
+        double quantile(double quantile) const;
+    };
+
+    using Snapshot = std::vector<Sample>;
+    using Exporter = std::function<void(const Sample& sample)>;
+
+    // Metric handles of one call site by label values, declared thread_local so hot paths skip the registry lock.
+    // Handles are dropped whenever the thread records into another context's registry.
+    template <typename Handles>
+    class HandleCache {
+    private:
+        uint64_t m_registryId = 0;
+        std::string m_key;
+        std::unordered_map<std::string, Handles> m_handles;
+
+    public:
+        template <typename Create>
+        const Handles& get(std::initializer_list<std::string_view> labelValues, Create&& create) {
+            uint64_t registryId = RegistryId();
+            if (registryId != m_registryId) {
+                m_handles.clear();
+                m_registryId = registryId;
+            }
+
+            m_key.clear();
+            for (std::string_view value : labelValues) {
+                m_key += value;
+                m_key += '\0';
+            }
+            auto handles = m_handles.find(m_key);
+            if (handles == m_handles.end())
+                handles = m_handles.emplace(m_key, create()).first;
+            return handles->second;
+        }
+    };
+
+private:
+    using Key = std::pair<std::string, Labels>;
+
+private:
+    uint64_t m_id = 0;
+    mutable std::shared_mutex m_mutex;
+    std::map<Key, std::unique_ptr<Counter>> m_counters;
+    std::map<Key, std::unique_ptr<Histogram>> m_histograms;
+
+private:
+    Metrics();
+
+    static Metrics& Instance();
+
+    friend class Context;
+
+public:
+    // Unique for every registry created by the process.
+    static uint64_t RegistryId();
+
+    // Returned references stay valid for the lifetime of the context.
+    static Counter& GetCounter(const std::string& name, const Labels& labels = {});
+
+    static Histogram& GetHistogram(const std::string& name, const Labels& labels = {});
+
+    // Registered metrics followed by JS evaluation and cache statistics, ordered by name.
+    static Snapshot Collect();
+
+    static void Export(const Exporter& exporter);
+
+    static std::string Prometheus();
+};
+
+} // namespace ytcpp
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+using nlohmann::json;
+
+#include "ytcpp/core/lru_cache.hpp"
+#include "ytcpp/yt_error.hpp"
+
+namespace ytcpp {
+
+class NegativeCache {
+public:
+    using Ttls = std::unordered_map<YtError::Type, std::chrono::seconds>;
+    using Stats = LruCache<std::string, YtError>::Stats;
+
+private:
+    std::mutex m_mutex;
+    Ttls m_ttls;
+    LruCache<std::string, YtError> m_errors;
+
+private:
+    NegativeCache();
+
+    static NegativeCache& Instance();
+
+    friend class Context;
+
+public:
+    static Ttls DefaultTtls();
+
+    static void Check(const std::string& videoId);
+
+    static void CheckPlayability(const std::string& videoId, const json& object);
+
+    static void Store(const std::string& videoId, const YtError& error);
+
+    static void Invalidate(const std::string& videoId);
+
+    static void Invalidate(YtError::Type type);
+
+    static void Clear();
+
+    static void SetTtl(YtError::Type type, std::chrono::seconds ttl);
+
+    static Stats GetStats();
+};
+
+} // namespace ytcpp
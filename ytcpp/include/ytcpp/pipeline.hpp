@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ytcpp/core/bounded_queue.hpp"
+#include "ytcpp/context.hpp"
+#include "ytcpp/format.hpp"
+#include "ytcpp/video.hpp"
+
+namespace ytcpp {
+
+// Resolve -> decipher -> sink stages connected by bounded queues, each served by its own workers.
+// A full queue blocks the stage feeding it, so backpressure reaches push() and memory stays bounded.
+class Pipeline {
+public:
+    struct Item {
+        size_t index = 0;
+        std::string input;
+        std::optional<Video> video;
+        std::optional<Format::List> formats;
+        std::vector<const Format*> selected;
+        std::exception_ptr error;
+    };
+
+    using Selector = std::function<std::vector<const Format*>(const Item& item)>;
+    using Sink = std::function<void(const Item& item)>;
+    using Completion = std::function<void(Item&& item)>;
+
+    struct Options {
+        size_t queueCapacity = 8;
+        size_t resolveWorkers = 4;
+        size_t decipherWorkers = 2;
+        size_t sinkWorkers = 2;
+        bool resolveVideo = true;
+        // Formats to decipher, all of them if unset.
+        Selector selector;
+        // Final stage, e.g. a download of the selected formats.
+        Sink sink;
+        // Called once per item, serialized, with the error of the stage that failed if any.
+        Completion completion;
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint64_t failed = 0;
+    };
+
+private:
+    using Stage = void (Pipeline::*)(Item& item);
+
+private:
+    Context& m_context;
+    Options m_options;
+    BoundedQueue<Item> m_resolveQueue;
+    BoundedQueue<Item> m_decipherQueue;
+    BoundedQueue<Item> m_sinkQueue;
+    std::atomic<size_t> m_resolveWorkers = 0;
+    std::atomic<size_t> m_decipherWorkers = 0;
+    std::atomic<size_t> m_sinkWorkers = 0;
+    std::atomic<uint64_t> m_submitted = 0;
+    std::atomic<uint64_t> m_completed = 0;
+    std::atomic<uint64_t> m_failed = 0;
+    std::mutex m_completionMutex;
+    std::vector<std::thread> m_threads;
+
+public:
+    Pipeline(Options options, Context& context = Context::Current());
+
+    Pipeline(const Pipeline&) = delete;
+
+    ~Pipeline();
+
+public:
+    Pipeline& operator=(const Pipeline&) = delete;
+
+private:
+    void run(BoundedQueue<Item>& input, BoundedQueue<Item>* output, std::atomic<size_t>& workers, Stage stage);
+
+    void resolve(Item& item);
+
+    void decipher(Item& item);
+
+    void sink(Item& item);
+
+    void complete(Item&& item);
+
+public:
+    // Blocks while the first stage is full, returns false once the pipeline is closed.
+    bool push(const std::string& videoIdOrUrl);
+
+    void close();
+
+    // Closes the pipeline and waits for every pushed item to complete.
+    void wait();
+
+public:
+    inline Stats stats() const {
+        return { m_submitted, m_completed, m_failed };
+    }
+};
+
+} // namespace ytcpp
@@ -1,29 +1,68 @@
 #pragma once
 
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <stop_token>
 #include <string>
+#include <vector>
 
 #include "ytcpp/core/js.hpp"
+#include "ytcpp/core/lru_cache.hpp"
+#include "ytcpp/core/shared_table.hpp"
+#include "ytcpp/core/task.hpp"
+#include "ytcpp/cipher.hpp"
 
 namespace ytcpp {
 
+class Context;
+class Stopwatch;
+
 class Player {
+public:
+    using NsigCache = LruCache<std::string, std::string>;
+
 public:
     static std::string GetPlayerId();
 
+    static Task<std::string> GetPlayerIdAsync(std::stop_token stopToken, Context& context);
+
+    static NsigCache::Stats NsigCacheStats();
+
+    static void UseSharedCache(const std::string& name, size_t slotCount = SharedTable::DefaultSlotCount);
+
+    static void DisableSharedCache();
+
+    static std::optional<SharedTable::Stats> SharedCacheStats();
+
 private:
-    std::mutex m_mutex;
+    mutable std::mutex m_mutex;
     std::string m_id;
     mutable Js::Interpreter m_interpreter;
     std::string m_sigFunction;
+    std::optional<Cipher> m_cipher;
     std::string m_nsigFunction;
     int m_signatureTimestamp = 0;
 
 public:
     Player(const std::string& id);
 
+    // Builds from player code obtained elsewhere, such as an archived base.js, without looking for a snapshot.
+    Player(const std::string& id, const std::string& code);
+
+private:
+    void build(const std::string& code, Stopwatch& stopwatch);
+
+    bool loadArtifact();
+
+    void saveArtifact(const std::string& bytecode, const std::string& sigFunctionCode, const std::string& signatureObjectCode) const;
+
+    void compileCipher(const std::string& functionCode, const std::string& objectCode);
+
 public:
-    std::string prepareUrl(std::string url) const;
+    std::string prepareUrl(const std::string& url) const;
+
+    std::vector<std::string> prepareUrls(const std::vector<std::string>& urls) const;
 
 public:
     inline const std::string& id() const {
@@ -33,6 +72,11 @@ public:
     inline int signatureTimestamp() const {
         return m_signatureTimestamp;
     }
+
+    inline Js::Interpreter::Statistics interpreterStatistics() const {
+        std::lock_guard lock(m_mutex);
+        return m_interpreter.statistics();
+    }
 };
 
 } // namespace ytcpp
@@ -1,13 +1,21 @@
 #pragma once
 
+#include <cstdint>
+#include <deque>
 #include <string>
 #include <vector>
 #include <iterator>
 #include <cstddef>
+#include <functional>
+#include <future>
+#include <stop_token>
 
 #include <nlohmann/json.hpp>
 using nlohmann::json;
 
+#include "ytcpp/core/curl.hpp"
+#include "ytcpp/core/task.hpp"
+#include "ytcpp/context.hpp"
 #include "ytcpp/thumbnail.hpp"
 #include "ytcpp/video.hpp"
 #include "ytcpp/yt_error.hpp"
@@ -65,8 +73,10 @@ public:
         }
 
         inline Iterator& operator++() {
-            if (m_video)
-                m_video = m_root->discoverVideo(++m_index);
+            if (m_video) {
+                m_video = m_root->discoverVideo(m_index + 1);
+                ++m_index;
+            }
             return *this;
         }
 
@@ -101,27 +111,121 @@ public:
         }
     };
 
+    class Snapshot {
+    public:
+        struct Entry {
+            std::string id;
+            std::string title;
+            std::string channel;
+            uint32_t durationSeconds = 0;
+        };
+
+    public:
+        static Snapshot Deserialize(const std::string& data);
+
+    private:
+        std::string m_playlistId;
+        std::vector<Entry> m_entries;
+
+    public:
+        Snapshot() = default;
+
+        Snapshot(const std::string& playlistId, std::vector<Entry>&& entries)
+            : m_playlistId(playlistId)
+            , m_entries(std::move(entries))
+        {}
+
+    public:
+        std::string serialize() const;
+
+    public:
+        inline const std::string& playlistId() const {
+            return m_playlistId;
+        }
+
+        inline const std::vector<Entry>& entries() const {
+            return m_entries;
+        }
+
+        inline size_t size() const {
+            return m_entries.size();
+        }
+
+        inline bool empty() const {
+            return m_entries.empty();
+        }
+    };
+
+    struct Diff {
+        std::vector<Video> added;
+        std::vector<std::string> removed;
+        std::vector<std::string> moved;
+        Snapshot snapshot;
+    };
+
+public:
+    using PageCallback = std::function<bool(std::vector<Video>&& videos)>;
+
+public:
+    static std::future<Playlist> Async(const std::string& playlistIdOrUrl, Context& context = Context::Current());
+
+    static Task<Playlist> Fetch(std::string playlistIdOrUrl, std::stop_token stopToken = {}, Context& context = Context::Current());
+
+    // Builds the playlist from a "browse" response obtained elsewhere, such as a recorded one.
+    static Playlist Parse(const std::string& playlistId, const std::string& response, Context& context = Context::Current());
+
+public:
+    static constexpr size_t DefaultPrefetchDistance = 30;
+
 private:
+    Context* m_context = nullptr;
     std::string m_id;
     std::string m_title;
     std::string m_channel;
     Thumbnail::List m_thumbnails;
     int m_videoCount = -1;
-    std::vector<Video> m_videos;
+    std::deque<Video> m_videos;
     std::string m_continuation;
+    Context::Pending<Curl::Response> m_prefetch;
+    size_t m_prefetchDistance = DefaultPrefetchDistance;
+
+private:
+    Playlist() = default;
 
 public:
-    Playlist(const std::string& playlistIdOrUrl);
+    Playlist(const std::string& playlistIdOrUrl, Context& context = Context::Current());
 
-    Playlist(const json& object);
+    Playlist(const json& object, Context& context = Context::Current());
 
 private:
     void extract();
 
+    void parse(const Curl::Response& response);
+
     void parseVideos(const json& object);
 
+    void parseContinuation(const Curl::Response& response);
+
+    void prefetchContinuation();
+
+    void fetchContinuation();
+
     Iterator::pointer discoverVideo(size_t index);
 
+    // Also reports the video count of the first page, before the callback sees it.
+    size_t fetchPages(const PageCallback& callback, size_t limit, int& videoCount) const;
+
+public:
+    size_t fetchAll(const PageCallback& callback, size_t limit = 0) const;
+
+    Diff sync(const Snapshot& previous = {}) const;
+
+    // Appends the next page of videos and returns how many were added, zero once the playlist is exhausted.
+    Task<size_t> fetchPage(std::stop_token stopToken = {});
+
+    // Appends a continuation page obtained elsewhere and returns how many videos were added.
+    size_t appendPage(const std::string& response);
+
 public:
     inline const std::string& id() const {
         return m_id;
@@ -147,6 +251,14 @@ public:
         return m_videoCount;
     }
 
+    inline size_t prefetchDistance() const {
+        return m_prefetchDistance;
+    }
+
+    inline void setPrefetchDistance(size_t distance) {
+        m_prefetchDistance = distance;
+    }
+
     inline bool empty() const {
         return m_videos.empty();
     }
@@ -2,8 +2,16 @@
 
 #include <string>
 #include <vector>
+#include <future>
+#include <iterator>
+#include <cstddef>
+#include <stop_token>
 
+#include "ytcpp/core/curl.hpp"
+#include "ytcpp/core/task.hpp"
+#include "ytcpp/context.hpp"
 #include "ytcpp/item.hpp"
+#include "ytcpp/yt_error.hpp"
 
 namespace ytcpp {
 
@@ -34,8 +42,116 @@ public:
     }
 };
 
-SearchResults QuerySearch(const std::string& query);
+class SearchStream {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Item;
+        using pointer = const Item*;
+        using reference = const Item&;
+
+    private:
+        SearchStream* m_stream = nullptr;
+
+    public:
+        Iterator() = default;
+
+        Iterator(SearchStream* stream)
+            : m_stream(stream->current() ? stream : nullptr)
+        {}
+
+    public:
+        inline pointer operator->() const {
+            if (!m_stream)
+                throw YtError(YtError::Type::InvalidIterator, "Invalid iterator");
+            return m_stream->current();
+        }
+
+        inline reference operator*() const {
+            if (!m_stream)
+                throw YtError(YtError::Type::InvalidIterator, "Invalid iterator");
+            return *m_stream->current();
+        }
+
+        inline Iterator& operator++() {
+            if (m_stream && !m_stream->advance())
+                m_stream = nullptr;
+            return *this;
+        }
+
+        inline void operator++(int) {
+            ++(*this);
+        }
+
+        inline operator bool() const {
+            return static_cast<bool>(m_stream);
+        }
+
+        friend inline bool operator==(const Iterator& left, const Iterator& right) {
+            return (left.m_stream == right.m_stream);
+        }
+
+        friend inline bool operator!=(const Iterator& left, const Iterator& right) {
+            return (left.m_stream != right.m_stream);
+        }
+    };
+
+private:
+    Context* m_context = nullptr;
+    std::string m_query;
+    SearchResults m_page;
+    size_t m_position = 0;
+    size_t m_pages = 0;
+    std::string m_continuation;
+    Context::Pending<Curl::Response> m_nextPage;
+
+public:
+    SearchStream(const std::string& query, Context& context = Context::Current());
+
+    SearchStream(const SearchStream&) = delete;
+
+public:
+    SearchStream& operator=(const SearchStream&) = delete;
+
+private:
+    void loadPage(const Curl::Response& response);
+
+    void requestNextPage();
+
+    const Item* current();
+
+    bool advance();
+
+public:
+    inline const std::string& query() const {
+        return m_query;
+    }
+
+    inline size_t pages() const {
+        return m_pages;
+    }
+
+    inline Iterator begin() {
+        return { this };
+    }
+
+    inline Iterator end() {
+        return {};
+    }
+};
+
+SearchResults QuerySearch(const std::string& query, Context& context = Context::Current());
+
+SearchResults RelatedSearch(const std::string& videoIdOrUrl, Context& context = Context::Current());
+
+std::future<SearchResults> QuerySearchAsync(const std::string& query, Context& context = Context::Current());
+
+std::future<SearchResults> RelatedSearchAsync(const std::string& videoIdOrUrl, Context& context = Context::Current());
+
+Task<SearchResults> FetchQuerySearch(std::string query, std::stop_token stopToken = {}, Context& context = Context::Current());
 
-SearchResults RelatedSearch(const std::string& videoIdOrUrl);
+Task<SearchResults> FetchRelatedSearch(std::string videoIdOrUrl, std::stop_token stopToken = {}, Context& context = Context::Current());
 
 } // namespace ytcpp
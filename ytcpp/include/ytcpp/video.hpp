@@ -2,11 +2,16 @@
 
 #include <string>
 #include <cstdint>
+#include <future>
+#include <stop_token>
 
 #include <boost/date_time.hpp>
 namespace dt = boost::gregorian;
 namespace pt = boost::posix_time;
 
+#include "ytcpp/core/curl.hpp"
+#include "ytcpp/core/task.hpp"
+#include "ytcpp/context.hpp"
 #include "ytcpp/thumbnail.hpp"
 
 namespace ytcpp {
@@ -17,6 +22,10 @@ public:
 
     static Video ParseTileRenderer(const json& object);
 
+    static std::future<Video> Async(const std::string& videoIdOrUrl, Context& context = Context::Current());
+
+    static Task<Video> Fetch(std::string videoIdOrUrl, std::stop_token stopToken = {}, Context& context = Context::Current());
+
 private:
     std::string m_id;
     std::string m_title;
@@ -29,12 +38,16 @@ private:
 private:
     Video() = default;
 
+    friend class Catalog;
+
 public:
-    Video(const std::string& videoIdOrUrl);
+    Video(const std::string& videoIdOrUrl, Context& context = Context::Current());
 
 private:
     void extract();
 
+    void parse(const Curl::Response& response);
+
 public:
     inline const std::string& id() const {
         return m_id;
@@ -18,6 +18,7 @@ public:
         Unplayable,
         Unavailable,
         LoginRequired,
+        Cancelled,
     };
 
 public:
@@ -39,6 +40,8 @@ public:
                 return "Unavailable item";
             case Type::LoginRequired:
                 return "Login required";
+            case Type::Cancelled:
+                return "Cancelled operation";
             default:
                 return "<unknown error type>";
         }
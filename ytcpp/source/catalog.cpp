@@ -0,0 +1,462 @@
+#include "ytcpp/catalog.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ytcpp/core/error.hpp"
+#include "ytcpp/core/logger.hpp"
+#include "ytcpp/core/stopwatch.hpp"
+
+namespace ytcpp {
+
+namespace Layout {
+    constexpr char DataMagic[8] = { 'Y', 'T', 'C', 'P', 'C', 'A', 'T', 'D' };
+    constexpr char IndexMagic[8] = { 'Y', 'T', 'C', 'P', 'C', 'A', 'T', 'I' };
+    constexpr uint32_t Version = 1;
+    constexpr uint64_t DataHeaderSize = 16;
+    constexpr uint64_t MinimalDataMapping = 1 << 20;
+    constexpr uint64_t InitialIndexCapacity = 1024;
+    constexpr uint8_t LivestreamFlag = 1 << 0;
+    constexpr uint8_t UpcomingFlag = 1 << 1;
+}
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t capacity;
+    uint64_t count;
+    uint64_t dataSize;
+};
+
+struct IndexSlot {
+    uint64_t hash;
+    uint64_t offset;
+};
+
+struct RecordHeader {
+    uint32_t size;
+    uint32_t titleLength;
+    uint32_t channelLength;
+    uint16_t thumbnailCount;
+    uint8_t idLength;
+    uint8_t flags;
+    int64_t durationSeconds;
+};
+
+struct ThumbnailHeader {
+    uint32_t width;
+    uint32_t height;
+    uint32_t urlLength;
+};
+
+static uint64_t HashId(std::string_view id) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char character : id) {
+        hash ^= static_cast<uint8_t>(character);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t Align(uint64_t size) {
+    return (size + 7) & ~uint64_t(7);
+}
+
+static RecordHeader ReadHeader(const char* record) {
+    RecordHeader header;
+    std::memcpy(&header, record, sizeof(header));
+    return header;
+}
+
+// Size of a complete record, or zero when its fields run past the record or the available data.
+static uint64_t CheckRecord(const char* record, uint64_t available) {
+    if (available < sizeof(RecordHeader))
+        return 0;
+    RecordHeader header = ReadHeader(record);
+    uint64_t recordSize = Align(sizeof(RecordHeader) + header.size);
+    uint64_t used = uint64_t(header.idLength) + header.titleLength + header.channelLength;
+    if (header.idLength == 0 || recordSize > available || used > header.size)
+        return 0;
+
+    const char* cursor = record + sizeof(RecordHeader) + used;
+    for (uint16_t index = 0; index < header.thumbnailCount; ++index) {
+        if (header.size - used < sizeof(ThumbnailHeader))
+            return 0;
+        ThumbnailHeader thumbnail;
+        std::memcpy(&thumbnail, cursor, sizeof(thumbnail));
+        used += sizeof(thumbnail);
+        if (header.size - used < thumbnail.urlLength)
+            return 0;
+        used += thumbnail.urlLength;
+        cursor += sizeof(thumbnail) + thumbnail.urlLength;
+    }
+    return recordSize;
+}
+
+// Slots may only reference records the index was written for.
+static bool SlotsWithin(const IndexHeader* header, uint64_t dataSize) {
+    const IndexSlot* slots = reinterpret_cast<const IndexSlot*>(header + 1);
+    for (uint64_t slot = 0; slot < header->capacity; ++slot) {
+        uint64_t offset = slots[slot].offset;
+        if (offset && (offset < Layout::DataHeaderSize || offset >= dataSize))
+            return false;
+    }
+    return true;
+}
+
+static void WriteAll(int file, const char* data, size_t size, uint64_t offset, const std::string& path) {
+    while (size) {
+        ssize_t written = pwrite(file, data, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            throw YTCPP_LOCATED_ERROR("Couldn't write \"{}\" file ({})", path, std::strerror(errno));
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+}
+
+static int OpenFile(const std::string& path) {
+    int file = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (file < 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't create/open \"{}\" file ({})", path, std::strerror(errno));
+    return file;
+}
+
+static uint64_t FileSize(int file, const std::string& path) {
+    struct stat status = {};
+    if (fstat(file, &status) != 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't get \"{}\" file size ({})", path, std::strerror(errno));
+    return static_cast<uint64_t>(status.st_size);
+}
+
+static void* Map(int file, size_t size, int protection, const std::string& path) {
+    void* address = mmap(nullptr, size, protection, MAP_SHARED, file, 0);
+    if (address == MAP_FAILED)
+        throw YTCPP_LOCATED_ERROR("Couldn't map \"{}\" file ({})", path, std::strerror(errno));
+    return address;
+}
+
+std::string_view Catalog::Entry::id() const {
+    RecordHeader header = ReadHeader(m_record);
+    return { m_record + sizeof(RecordHeader), header.idLength };
+}
+
+std::string_view Catalog::Entry::title() const {
+    RecordHeader header = ReadHeader(m_record);
+    return { m_record + sizeof(RecordHeader) + header.idLength, header.titleLength };
+}
+
+std::string_view Catalog::Entry::channel() const {
+    RecordHeader header = ReadHeader(m_record);
+    return { m_record + sizeof(RecordHeader) + header.idLength + header.titleLength, header.channelLength };
+}
+
+pt::time_duration Catalog::Entry::duration() const {
+    return pt::seconds(ReadHeader(m_record).durationSeconds);
+}
+
+bool Catalog::Entry::isLivestream() const {
+    return ReadHeader(m_record).flags & Layout::LivestreamFlag;
+}
+
+bool Catalog::Entry::isUpcoming() const {
+    return ReadHeader(m_record).flags & Layout::UpcomingFlag;
+}
+
+Thumbnail::List Catalog::Entry::thumbnails() const {
+    RecordHeader header = ReadHeader(m_record);
+    const char* cursor = m_record + sizeof(RecordHeader) + header.idLength + header.titleLength + header.channelLength;
+
+    Thumbnail::List thumbnails;
+    thumbnails.reserve(header.thumbnailCount);
+    for (uint16_t index = 0; index < header.thumbnailCount; ++index) {
+        ThumbnailHeader thumbnail;
+        std::memcpy(&thumbnail, cursor, sizeof(thumbnail));
+        cursor += sizeof(thumbnail);
+        thumbnails.emplace_back(std::string(cursor, thumbnail.urlLength), Dimensions(thumbnail.width, thumbnail.height));
+        cursor += thumbnail.urlLength;
+    }
+    return thumbnails;
+}
+
+Video Catalog::Entry::video() const {
+    return MakeVideo(*this);
+}
+
+Video Catalog::MakeVideo(const Entry& entry) {
+    Video video;
+    video.m_id = entry.id();
+    video.m_title = entry.title();
+    video.m_channel = entry.channel();
+    video.m_thumbnails = entry.thumbnails();
+    video.m_duration = entry.duration();
+    video.m_isLivestream = entry.isLivestream();
+    video.m_isUpcoming = entry.isUpcoming();
+    return video;
+}
+
+Catalog::Catalog(const std::string& path)
+    : m_dataPath(path + ".data")
+    , m_indexPath(path + ".index") {
+    Stopwatch stopwatch;
+    m_dataFile = OpenFile(m_dataPath);
+    m_dataSize = FileSize(m_dataFile, m_dataPath);
+    if (m_dataSize == 0) {
+        char header[Layout::DataHeaderSize] = {};
+        std::memcpy(header, Layout::DataMagic, sizeof(Layout::DataMagic));
+        std::memcpy(header + sizeof(Layout::DataMagic), &Layout::Version, sizeof(Layout::Version));
+        WriteAll(m_dataFile, header, sizeof(header), 0, m_dataPath);
+        m_dataSize = sizeof(header);
+    }
+
+    char header[Layout::DataHeaderSize] = {};
+    uint32_t version = 0;
+    if (pread(m_dataFile, header, sizeof(header), 0) == sizeof(header))
+        std::memcpy(&version, header + sizeof(Layout::DataMagic), sizeof(version));
+    if (std::memcmp(header, Layout::DataMagic, sizeof(Layout::DataMagic)) != 0 || version != Layout::Version) {
+        close(m_dataFile);
+        throw YTCPP_LOCATED_ERROR("\"{}\" isn't a catalog data file of version {}", m_dataPath, Layout::Version);
+    }
+    mapData(m_dataSize);
+
+    m_indexFile = OpenFile(m_indexPath);
+    uint64_t indexSize = FileSize(m_indexFile, m_indexPath);
+    IndexHeader indexHeader = {};
+    bool indexValid = indexSize >= sizeof(IndexHeader)
+        && pread(m_indexFile, &indexHeader, sizeof(indexHeader), 0) == sizeof(indexHeader)
+        && std::memcmp(indexHeader.magic, Layout::IndexMagic, sizeof(Layout::IndexMagic)) == 0
+        && indexHeader.version == Layout::Version
+        && indexHeader.capacity && (indexHeader.capacity & (indexHeader.capacity - 1)) == 0
+        && indexSize == sizeof(IndexHeader) + indexHeader.capacity * sizeof(IndexSlot)
+        && indexHeader.dataSize >= Layout::DataHeaderSize && indexHeader.dataSize <= m_dataSize;
+
+    if (indexValid) {
+        m_index = { Map(m_indexFile, indexSize, PROT_READ | PROT_WRITE, m_indexPath), indexSize };
+        if (!SlotsWithin(static_cast<const IndexHeader*>(m_index.address), indexHeader.dataSize)) {
+            munmap(m_index.address, m_index.size);
+            m_index = {};
+            indexValid = false;
+        }
+    }
+
+    if (indexValid) {
+        indexRecords(indexHeader.dataSize);
+    }
+    else {
+        if (indexSize)
+            Logger::Warn("Catalog index \"{}\" is invalid, rebuilding", m_indexPath);
+        createIndex(Layout::InitialIndexCapacity);
+        indexRecords(Layout::DataHeaderSize);
+    }
+
+    stopwatch.stop();
+    Logger::Debug("Catalog \"{}\": Opened with {} videos ({} ms)", path, size(), stopwatch.ms());
+}
+
+Catalog::~Catalog() {
+    for (const Mapping& mapping : m_retiredData)
+        munmap(mapping.address, mapping.size);
+    if (m_data.address)
+        munmap(m_data.address, m_data.size);
+    if (m_index.address)
+        munmap(m_index.address, m_index.size);
+    if (m_dataFile >= 0)
+        close(m_dataFile);
+    if (m_indexFile >= 0)
+        close(m_indexFile);
+}
+
+void Catalog::mapData(uint64_t size) {
+    if (size <= m_data.size)
+        return;
+
+    // Older mappings stay alive so entries handed out earlier remain valid.
+    uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t mappingSize = std::max({ size, m_data.size * 2, Layout::MinimalDataMapping });
+    mappingSize = (mappingSize + pageSize - 1) / pageSize * pageSize;
+    void* address = Map(m_dataFile, mappingSize, PROT_READ, m_dataPath);
+    if (m_data.address)
+        m_retiredData.push_back(m_data);
+    m_data = { address, mappingSize };
+}
+
+void Catalog::createIndex(uint64_t capacity) {
+    std::string temporaryPath = m_indexPath + ".tmp";
+    int file = open(temporaryPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file < 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't create/open \"{}\" file ({})", temporaryPath, std::strerror(errno));
+
+    size_t size = sizeof(IndexHeader) + capacity * sizeof(IndexSlot);
+    if (ftruncate(file, static_cast<off_t>(size)) != 0) {
+        close(file);
+        throw YTCPP_LOCATED_ERROR("Couldn't resize \"{}\" file ({})", temporaryPath, std::strerror(errno));
+    }
+
+    Mapping index = { Map(file, size, PROT_READ | PROT_WRITE, temporaryPath), size };
+    IndexHeader* header = static_cast<IndexHeader*>(index.address);
+    std::memcpy(header->magic, Layout::IndexMagic, sizeof(Layout::IndexMagic));
+    header->version = Layout::Version;
+    header->capacity = capacity;
+    header->dataSize = Layout::DataHeaderSize;
+
+    Mapping previousIndex = m_index;
+    int previousFile = m_indexFile;
+    m_index = index;
+    m_indexFile = file;
+    if (previousIndex.address) {
+        const IndexHeader* previousHeader = static_cast<const IndexHeader*>(previousIndex.address);
+        const IndexSlot* slots = reinterpret_cast<const IndexSlot*>(previousHeader + 1);
+        for (uint64_t slot = 0; slot < previousHeader->capacity; ++slot) {
+            if (slots[slot].offset)
+                insert(slots[slot].hash, slots[slot].offset);
+        }
+        header->dataSize = previousHeader->dataSize;
+        munmap(previousIndex.address, previousIndex.size);
+    }
+    if (previousFile >= 0)
+        close(previousFile);
+
+    if (rename(temporaryPath.c_str(), m_indexPath.c_str()) != 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't replace \"{}\" file ({})", m_indexPath, std::strerror(errno));
+}
+
+void Catalog::growIndex() {
+    const IndexHeader* header = static_cast<const IndexHeader*>(m_index.address);
+    createIndex(header->capacity * 2);
+}
+
+void Catalog::indexRecords(uint64_t offset) {
+    const char* data = static_cast<const char*>(m_data.address);
+    while (offset < m_dataSize) {
+        uint64_t recordSize = CheckRecord(data + offset, m_dataSize - offset);
+        if (!recordSize)
+            break;
+
+        insert(HashId(Entry(data + offset).id()), offset);
+        offset += recordSize;
+    }
+
+    // Torn tail of an interrupted write is dropped.
+    if (offset != m_dataSize) {
+        Logger::Warn("Catalog \"{}\": Dropping {} bytes of incomplete records", m_dataPath, m_dataSize - offset);
+        if (ftruncate(m_dataFile, static_cast<off_t>(offset)) != 0)
+            throw YTCPP_LOCATED_ERROR("Couldn't truncate \"{}\" file ({})", m_dataPath, std::strerror(errno));
+        m_dataSize = offset;
+    }
+    static_cast<IndexHeader*>(m_index.address)->dataSize = m_dataSize;
+}
+
+void Catalog::insert(uint64_t hash, uint64_t offset) {
+    IndexHeader* header = static_cast<IndexHeader*>(m_index.address);
+    if ((header->count + 1) * 10 > header->capacity * 7) {
+        growIndex();
+        header = static_cast<IndexHeader*>(m_index.address);
+    }
+
+    const char* data = static_cast<const char*>(m_data.address);
+    std::string_view id = Entry(data + offset).id();
+    IndexSlot* slots = reinterpret_cast<IndexSlot*>(header + 1);
+    uint64_t mask = header->capacity - 1;
+    for (uint64_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        if (!slots[slot].offset) {
+            slots[slot] = { hash, offset };
+            ++header->count;
+            return;
+        }
+        if (slots[slot].hash == hash && Entry(data + slots[slot].offset).id() == id) {
+            slots[slot].offset = offset;
+            return;
+        }
+    }
+}
+
+std::optional<uint64_t> Catalog::locate(std::string_view id) const {
+    const IndexHeader* header = static_cast<const IndexHeader*>(m_index.address);
+    const IndexSlot* slots = reinterpret_cast<const IndexSlot*>(header + 1);
+    const char* data = static_cast<const char*>(m_data.address);
+    uint64_t hash = HashId(id), mask = header->capacity - 1;
+    for (uint64_t slot = hash & mask; slots[slot].offset; slot = (slot + 1) & mask) {
+        if (slots[slot].hash == hash && Entry(data + slots[slot].offset).id() == id)
+            return slots[slot].offset;
+    }
+    return std::nullopt;
+}
+
+std::optional<Catalog::Entry> Catalog::find(std::string_view id) const {
+    std::shared_lock lock(m_mutex);
+    std::optional<uint64_t> offset = locate(id);
+    if (!offset)
+        return std::nullopt;
+    return Entry(static_cast<const char*>(m_data.address) + *offset);
+}
+
+bool Catalog::contains(std::string_view id) const {
+    std::shared_lock lock(m_mutex);
+    return locate(id).has_value();
+}
+
+void Catalog::put(const Video& video) {
+    if (video.id().empty() || video.id().size() > UINT8_MAX)
+        throw YTCPP_LOCATED_ERROR("Video id \"{}\" can't be stored in catalog", video.id());
+
+    std::string record(sizeof(RecordHeader), '\0');
+    record += video.id();
+    record += video.title();
+    record += video.channel();
+    size_t thumbnailCount = std::min<size_t>(video.thumbnails().size(), UINT16_MAX);
+    for (size_t index = 0; index < thumbnailCount; ++index) {
+        const Thumbnail& thumbnail = video.thumbnails()[index];
+        ThumbnailHeader thumbnailHeader = {
+            static_cast<uint32_t>(thumbnail.dimensions().width()),
+            static_cast<uint32_t>(thumbnail.dimensions().height()),
+            static_cast<uint32_t>(thumbnail.url().size())
+        };
+        record.append(reinterpret_cast<const char*>(&thumbnailHeader), sizeof(thumbnailHeader));
+        record += thumbnail.url();
+    }
+
+    RecordHeader header = {
+        static_cast<uint32_t>(record.size() - sizeof(RecordHeader)),
+        static_cast<uint32_t>(video.title().size()),
+        static_cast<uint32_t>(video.channel().size()),
+        static_cast<uint16_t>(thumbnailCount),
+        static_cast<uint8_t>(video.id().size()),
+        static_cast<uint8_t>((video.isLivestream() ? Layout::LivestreamFlag : 0) | (video.isUpcoming() ? Layout::UpcomingFlag : 0)),
+        static_cast<int64_t>(video.duration().total_seconds())
+    };
+    std::memcpy(record.data(), &header, sizeof(header));
+    record.resize(Align(record.size()), '\0');
+
+    std::unique_lock lock(m_mutex);
+    uint64_t offset = m_dataSize;
+    WriteAll(m_dataFile, record.data(), record.size(), offset, m_dataPath);
+    m_dataSize += record.size();
+    mapData(m_dataSize);
+    insert(HashId(video.id()), offset);
+    static_cast<IndexHeader*>(m_index.address)->dataSize = m_dataSize;
+}
+
+void Catalog::sync() {
+    std::unique_lock lock(m_mutex);
+    if (fdatasync(m_dataFile) != 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't flush \"{}\" file ({})", m_dataPath, std::strerror(errno));
+    if (msync(m_index.address, m_index.size, MS_SYNC) != 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't flush \"{}\" file ({})", m_indexPath, std::strerror(errno));
+}
+
+size_t Catalog::size() const {
+    std::shared_lock lock(m_mutex);
+    return static_cast<size_t>(static_cast<const IndexHeader*>(m_index.address)->count);
+}
+
+} // namespace ytcpp
@@ -0,0 +1,102 @@
+#include "ytcpp/cipher.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <map>
+
+#include <boost/regex.hpp>
+
+namespace ytcpp {
+
+namespace Regex {
+    const boost::regex ExtractFunctionBody(R"(\{\s*[a-zA-Z0-9_$]+\s*=\s*[a-zA-Z0-9_$]+\.split\(\s*[a-zA-Z0-9_$\[\]\"]+\s*\)\s*;([\s\S]*?);?\s*return\s)");
+    const boost::regex ExtractCall(R"(^\s*[a-zA-Z0-9_$]+(?:\.([a-zA-Z0-9_$]+)|\[\"([a-zA-Z0-9_$]+)\"\])\(\s*[a-zA-Z0-9_$]+\s*,\s*(\d+)\s*\)\s*$)");
+    const boost::regex ExtractMethod(R"(\"?([a-zA-Z0-9_$]+)\"?\s*:\s*function\s*\([^)]*\)\s*\{([^}]*)\})");
+    const boost::regex ReverseBody(R"(^\s*[a-zA-Z0-9_$]+\.reverse\(\s*\)\s*;?\s*$)");
+    const boost::regex SpliceBody(R"(^\s*[a-zA-Z0-9_$]+\.splice\(\s*0\s*,\s*[a-zA-Z0-9_$]+\s*\)\s*;?\s*$)");
+    const boost::regex SwapBody(R"(^\s*var\s+[a-zA-Z0-9_$]+\s*=\s*[a-zA-Z0-9_$]+\[\s*0\s*\]\s*;[^;]*%[^;]*\.length[^;]*;[^;]*;?\s*$)");
+}
+
+static std::optional<Cipher::Operation::Type> ClassifyMethod(const std::string& body) {
+    if (boost::regex_match(body, Regex::ReverseBody))
+        return Cipher::Operation::Type::Reverse;
+    if (boost::regex_match(body, Regex::SpliceBody))
+        return Cipher::Operation::Type::Splice;
+    if (boost::regex_match(body, Regex::SwapBody))
+        return Cipher::Operation::Type::Swap;
+    return std::nullopt;
+}
+
+static std::vector<std::string> SplitStatements(const std::string& body) {
+    std::vector<std::string> statements;
+    size_t begin = 0;
+    while (begin <= body.size()) {
+        size_t end = body.find(';', begin);
+        if (end == std::string::npos)
+            end = body.size();
+        if (body.find_first_not_of(" \t\r\n", begin) < end)
+            statements.push_back(body.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return statements;
+}
+
+std::optional<Cipher> Cipher::Compile(const std::string& functionCode, const std::string& objectCode) {
+    std::map<std::string, Operation::Type> methods;
+    for (boost::sregex_iterator method(objectCode.begin(), objectCode.end(), Regex::ExtractMethod), end; method != end; ++method) {
+        std::optional<Operation::Type> type = ClassifyMethod(method->str(2));
+        if (!type)
+            return std::nullopt;
+        methods.emplace(method->str(1), *type);
+    }
+
+    boost::smatch matches;
+    if (methods.empty() || !boost::regex_search(functionCode, matches, Regex::ExtractFunctionBody))
+        return std::nullopt;
+
+    std::vector<Operation> operations;
+    for (const std::string& statement : SplitStatements(matches.str(1))) {
+        boost::smatch callMatches;
+        if (!boost::regex_match(statement, callMatches, Regex::ExtractCall))
+            return std::nullopt;
+
+        auto method = methods.find(callMatches[1].matched ? callMatches.str(1) : callMatches.str(2));
+        if (method == methods.end())
+            return std::nullopt;
+
+        std::string argumentText = callMatches.str(3);
+        const char* argumentEnd = argumentText.data() + argumentText.size();
+        int argument = 0;
+        auto [end, error] = std::from_chars(argumentText.data(), argumentEnd, argument);
+        if (error != std::errc() || end != argumentEnd)
+            return std::nullopt;
+        operations.push_back({ method->second, argument });
+    }
+
+    if (operations.empty())
+        return std::nullopt;
+    return Cipher(std::move(operations));
+}
+
+std::string Cipher::apply(std::string signature) const {
+    for (const Operation& operation : m_operations) {
+        switch (operation.type) {
+            case Operation::Type::Reverse: {
+                std::reverse(signature.begin(), signature.end());
+                break;
+            }
+            case Operation::Type::Splice: {
+                signature.erase(0, std::min<size_t>(operation.argument, signature.size()));
+                break;
+            }
+            case Operation::Type::Swap: {
+                if (!signature.empty())
+                    std::swap(signature[0], signature[operation.argument % signature.size()]);
+                break;
+            }
+        }
+    }
+    return signature;
+}
+
+} // namespace ytcpp
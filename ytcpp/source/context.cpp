@@ -0,0 +1,160 @@
+#include "ytcpp/context.hpp"
+
+#include <utility>
+
+#include "ytcpp/core/cache.hpp"
+#include "ytcpp/core/curl.hpp"
+#include "ytcpp/core/logger.hpp"
+#include "ytcpp/innertube.hpp"
+#include "ytcpp/metrics.hpp"
+#include "ytcpp/negative_cache.hpp"
+#include "ytcpp/player.hpp"
+
+namespace ytcpp {
+
+static thread_local Context* CurrentContext = nullptr;
+
+Context::Scope::Scope(Context& context)
+    : m_previous(CurrentContext) {
+    CurrentContext = &context;
+}
+
+Context::Scope::~Scope() {
+    CurrentContext = m_previous;
+}
+
+Context::Work::Work(Context& context)
+    : m_context(&context) {
+    std::lock_guard lock(context.m_workMutex);
+    ++context.m_work;
+}
+
+Context::Work::Work(Work&& other) noexcept
+    : m_context(std::exchange(other.m_context, nullptr))
+{}
+
+Context::Work::~Work() {
+    if (!m_context)
+        return;
+
+    // Notified under the lock, the context may be gone as soon as it is released.
+    std::lock_guard lock(m_context->m_workMutex);
+    if (--m_context->m_work == 0)
+        m_context->m_workDone.notify_all();
+}
+
+Context::Context()
+    : m_logger(new Logger())
+    , m_metrics(new Metrics())
+    , m_curl(new Curl())
+    , m_cache(new Cache())
+    , m_innertube(new Innertube())
+    , m_negativeCache(new NegativeCache())
+    , m_formatLists(FormatListCacheCapacity)
+{}
+
+Context::~Context() {
+    // Requests in flight fail right away, so the coroutines awaiting them resume and finish first.
+    m_curl->close();
+    std::unique_lock lock(m_workMutex);
+    m_workDone.wait(lock, [this]() {
+        return m_work == 0;
+    });
+}
+
+static Context& CreateDefault() {
+    // Created first so the shared executor outlives the default context, which may still post to it.
+    Context::DefaultExecutor();
+    static Context instance;
+    return instance;
+}
+
+Context& Context::Default() {
+    static Context& instance = CreateDefault();
+    return instance;
+}
+
+Context& Context::Current() {
+    return CurrentContext ? *CurrentContext : Default();
+}
+
+std::shared_ptr<Executor> Context::DefaultExecutor() {
+    static std::shared_ptr<Executor> executor = std::make_shared<ThreadPool>();
+    return executor;
+}
+
+std::shared_ptr<const Player> Context::player(const std::string& playerId) {
+    std::promise<std::shared_ptr<const Player>> promise;
+    std::shared_future<std::shared_ptr<const Player>> player;
+    bool building = false;
+    {
+        std::lock_guard lock(m_playersMutex);
+        auto playerEntry = m_players.find(playerId);
+        if (playerEntry == m_players.end()) {
+            player = promise.get_future().share();
+            m_players.emplace(playerId, player);
+            building = true;
+        }
+        else {
+            player = playerEntry->second;
+        }
+    }
+    if (!building)
+        return player.get();
+
+    // Player code is downloaded and compiled outside the lock, other players stay available meanwhile.
+    try {
+        Scope scope(*this);
+        promise.set_value(std::make_shared<const Player>(playerId));
+    }
+    catch (...) {
+        {
+            std::lock_guard lock(m_playersMutex);
+            m_players.erase(playerId);
+        }
+        promise.set_exception(std::current_exception());
+    }
+    return player.get();
+}
+
+Executor& Context::ioExecutor() {
+    std::call_once(m_ioExecutorCreated, [this]() {
+        m_ioExecutor = std::make_unique<ThreadPool>(IoThreadCount);
+    });
+    return *m_ioExecutor;
+}
+
+std::shared_ptr<Executor> Context::executor() const {
+    std::shared_ptr<Executor> executor = m_executor.load();
+    return executor ? executor : DefaultExecutor();
+}
+
+void Context::setExecutor(std::shared_ptr<Executor> executor) {
+    m_executor.store(std::move(executor));
+}
+
+Logger& Logger::Instance() {
+    return *Context::Current().m_logger;
+}
+
+Curl& Curl::Instance() {
+    return *Context::Current().m_curl;
+}
+
+Cache& Cache::Instance() {
+    return *Context::Current().m_cache;
+}
+
+Innertube& Innertube::Instance() {
+    return *Context::Current().m_innertube;
+}
+
+NegativeCache& NegativeCache::Instance() {
+    return *Context::Current().m_negativeCache;
+}
+
+Metrics& Metrics::Instance() {
+    return *Context::Current().m_metrics;
+}
+
+} // namespace ytcpp
@@ -0,0 +1,126 @@
+#include "ytcpp/core/arena.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace ytcpp {
+
+Arena::~Arena() {
+    for (void* chunk : m_chunks)
+        std::free(chunk);
+}
+
+size_t Arena::SizeClass(size_t size) {
+    for (size_t sizeClass = 0; sizeClass < ClassCount; ++sizeClass) {
+        if (size <= ClassSize(sizeClass))
+            return sizeClass;
+    }
+    return ClassCount;
+}
+
+void* Arena::allocateSmall(size_t sizeClass) {
+    if (FreeBlock* block = m_freeLists[sizeClass]) {
+        m_freeLists[sizeClass] = block->next;
+        return block;
+    }
+
+    size_t blockSize = sizeof(Header) + ClassSize(sizeClass);
+    if (static_cast<size_t>(m_chunkEnd - m_cursor) < blockSize) {
+        void* chunk = std::malloc(ChunkSize);
+        if (!chunk)
+            return nullptr;
+
+        m_chunks.push_back(chunk);
+        m_cursor = static_cast<char*>(chunk);
+        m_chunkEnd = m_cursor + ChunkSize;
+        m_stats.reservedBytes += ChunkSize;
+    }
+
+    void* block = m_cursor + sizeof(Header);
+    m_cursor += blockSize;
+    return block;
+}
+
+void* Arena::allocate(size_t size) {
+    if (size == 0)
+        return nullptr;
+
+    if (m_limit && m_stats.currentBytes + size > m_limit) {
+        ++m_stats.failedAllocations;
+        return nullptr;
+    }
+
+    size_t sizeClass = SizeClass(size);
+    void* pointer = nullptr;
+    if (sizeClass < ClassCount) {
+        pointer = allocateSmall(sizeClass);
+    }
+    else if (void* block = std::malloc(sizeof(Header) + size)) {
+        pointer = static_cast<char*>(block) + sizeof(Header);
+        m_stats.reservedBytes += sizeof(Header) + size;
+    }
+
+    if (!pointer) {
+        ++m_stats.failedAllocations;
+        return nullptr;
+    }
+
+    Header* header = reinterpret_cast<Header*>(static_cast<char*>(pointer) - sizeof(Header));
+    header->size = size;
+    header->sizeClass = sizeClass;
+    m_stats.currentBytes += size;
+    m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.currentBytes);
+    ++m_stats.allocations;
+    return pointer;
+}
+
+void* Arena::reallocate(void* pointer, size_t size) {
+    if (!pointer)
+        return allocate(size);
+
+    if (size == 0) {
+        deallocate(pointer);
+        return nullptr;
+    }
+
+    Header* header = reinterpret_cast<Header*>(static_cast<char*>(pointer) - sizeof(Header));
+    if (header->sizeClass < ClassCount && size <= ClassSize(header->sizeClass)) {
+        if (size > header->size && m_limit && m_stats.currentBytes + (size - header->size) > m_limit) {
+            ++m_stats.failedAllocations;
+            return nullptr;
+        }
+
+        m_stats.currentBytes = m_stats.currentBytes - header->size + size;
+        m_stats.peakBytes = std::max(m_stats.peakBytes, m_stats.currentBytes);
+        header->size = size;
+        return pointer;
+    }
+
+    void* newPointer = allocate(size);
+    if (!newPointer)
+        return nullptr;
+
+    std::memcpy(newPointer, pointer, std::min(header->size, size));
+    deallocate(pointer);
+    return newPointer;
+}
+
+void Arena::deallocate(void* pointer) {
+    if (!pointer)
+        return;
+
+    Header* header = reinterpret_cast<Header*>(static_cast<char*>(pointer) - sizeof(Header));
+    m_stats.currentBytes -= header->size;
+    if (header->sizeClass < ClassCount) {
+        FreeBlock* block = static_cast<FreeBlock*>(pointer);
+        block->next = m_freeLists[header->sizeClass];
+        m_freeLists[header->sizeClass] = block;
+        return;
+    }
+
+    m_stats.reservedBytes -= sizeof(Header) + header->size;
+    std::free(header);
+}
+
+} // namespace ytcpp
@@ -1,73 +1,249 @@
 #include "ytcpp/core/cache.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
 #include <filesystem>
+#include <random>
 namespace fs = std::filesystem;
 
-#include <nlohmann/json.hpp>
-using nlohmann::json;
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#include <fmt/format.h>
 
 #include "ytcpp/core/error.hpp"
 #include "ytcpp/core/io.hpp"
 
 namespace ytcpp {
 
-constexpr const char* CacheFile = ".ytcpp_cache.json";
-namespace Objects {
-    namespace Auth {
-        constexpr const char* Object = "auth";
-        constexpr const char* Authorized = "authorized";
-        constexpr const char* AccessToken = "access_token";
-        constexpr const char* AccessTokenType = "access_token_type";
-        constexpr const char* ExpiresAt = "expires_at";
-        constexpr const char* RefreshToken = "refresh_token";
+// Serializes read-modify-write cycles of one key across processes.
+// Windows builds rely on the in-process key mutexes only.
+class FileLock {
+private:
+    int m_file = -1;
+
+public:
+    FileLock(const std::string& path) {
+#ifndef _WIN32
+        m_file = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (m_file < 0)
+            throw YTCPP_LOCATED_ERROR("Couldn't create/open \"{}\" file", path);
+        while (flock(m_file, LOCK_EX) != 0) {
+            if (errno == EINTR)
+                continue;
+            close(m_file);
+            throw YTCPP_LOCATED_ERROR("Couldn't lock \"{}\" file", path);
+        }
+#endif
+    }
+
+    FileLock(const FileLock&) = delete;
+
+    ~FileLock() {
+#ifndef _WIN32
+        flock(m_file, LOCK_UN);
+        close(m_file);
+#endif
     }
+
+public:
+    FileLock& operator=(const FileLock&) = delete;
+};
+
+static void CheckKey(const std::string& key) {
+    bool valid = !key.empty() && key.front() != '.' && std::all_of(key.begin(), key.end(), [](char character) {
+        return std::isalnum(static_cast<unsigned char>(character)) || character == '_' || character == '-' || character == '.';
+    });
+    if (!valid)
+        throw YTCPP_LOCATED_ERROR("Invalid cache key \"{}\"", key);
 }
 
-std::mutex Cache::Mutex;
+// Contents reach the disk before the caller renames the file over a good value.
+static void WriteSynced(const std::string& path, const std::string& contents) {
+#ifndef _WIN32
+    int file = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (file < 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't create \"{}\" file ({})", path, std::strerror(errno));
+
+    for (size_t written = 0; written < contents.size();) {
+        ssize_t result = write(file, contents.data() + written, contents.size() - written);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0) {
+            int error = errno;
+            close(file);
+            throw YTCPP_LOCATED_ERROR("Couldn't write \"{}\" file ({})", path, std::strerror(error));
+        }
+        written += static_cast<size_t>(result);
+    }
+    if (fsync(file) != 0) {
+        int error = errno;
+        close(file);
+        throw YTCPP_LOCATED_ERROR("Couldn't flush \"{}\" file ({})", path, std::strerror(error));
+    }
+    if (close(file) != 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't close \"{}\" file ({})", path, std::strerror(errno));
+#else
+    IO::WriteFile(path, contents);
+#endif
+}
+
+// Makes a rename into the directory survive a crash.
+static void SyncDirectory(const std::string& directory) {
+#ifndef _WIN32
+    int file = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (file < 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't open \"{}\" cache directory ({})", directory, std::strerror(errno));
+    int result = fsync(file);
+    int error = errno;
+    close(file);
+    if (result != 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't flush \"{}\" cache directory ({})", directory, std::strerror(error));
+#endif
+}
+
+static void CreateDirectory(const std::string& directory) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (error)
+        throw YTCPP_LOCATED_ERROR("Couldn't create \"{}\" cache directory ({})", directory, error.message());
+}
 
 Cache::Cache()
-    : m_lock(Mutex) {
-    if (!fs::is_regular_file(CacheFile)) {
-        save();
-        return;
+    : m_snapshot(std::make_shared<const Snapshot>())
+{}
+
+std::string Cache::Path(const std::string& key) {
+    CheckKey(key);
+    return (fs::path(Directory()) / key).string();
+}
+
+Cache::Value Cache::Load(const std::string& key) {
+    std::string path = Path(key);
+    if (!fs::is_regular_file(path))
+        return nullptr;
+
+    try {
+        return std::make_shared<const std::string>(IO::ReadFile(path));
+    }
+    catch (const Error&) {
+        // Erased by another process in the meantime.
+        if (!fs::exists(path))
+            return nullptr;
+        throw;
     }
+}
+
+void Cache::Store(const std::string& key, const std::string& value) {
+    static std::atomic<uint64_t> counter = 0;
+    static const uint32_t processTag = std::random_device()();
 
+    std::string path = Path(key);
+    std::string temporaryPath = fmt::format("{}.{:08x}.{}.tmp", path, processTag, counter.fetch_add(1));
     try {
-        std::string fileContents = IO::ReadFile(CacheFile);
-        json cacheJson = json::parse(fileContents);
-
-        json authObject = cacheJson.at(Objects::Auth::Object);
-        m_auth.authorized = authObject.at(Objects::Auth::Authorized);
-        m_auth.accessToken = authObject.at(Objects::Auth::AccessToken);
-        m_auth.accessTokenType = authObject.at(Objects::Auth::AccessTokenType);
-        m_auth.expiresAt = authObject.at(Objects::Auth::ExpiresAt);
-        m_auth.refreshToken = authObject.at(Objects::Auth::RefreshToken);
-        m_originalAuth = m_auth;
+        WriteSynced(temporaryPath, value);
     }
-    catch (const json::exception& error) {
-        throw YTCPP_LOCATED_ERROR("Couldn't parse cache file JSON [error id: {}]", error.id);
+    catch (const Error&) {
+        // A partial file must never replace the current value.
+        std::error_code ignored;
+        fs::remove(temporaryPath, ignored);
+        throw;
     }
+
+    std::error_code error;
+    fs::rename(temporaryPath, path, error);
+    if (error) {
+        std::error_code ignored;
+        fs::remove(temporaryPath, ignored);
+        throw YTCPP_LOCATED_ERROR("Couldn't replace \"{}\" cache file ({})", path, error.message());
+    }
+    SyncDirectory(fs::path(path).parent_path().string());
+}
+
+void Cache::Publish(const std::string& key, Value value) {
+    std::lock_guard lock(Instance().m_publishMutex);
+    auto snapshot = std::make_shared<Snapshot>(*Instance().m_snapshot.load());
+    if (value)
+        (*snapshot)[key] = std::move(value);
+    else
+        snapshot->erase(key);
+    Instance().m_snapshot.store(std::move(snapshot));
+}
+
+void Cache::SetDirectory(const std::string& directory) {
+    std::lock_guard lock(Instance().m_publishMutex);
+    Instance().m_directory = directory;
+    Instance().m_snapshot.store(std::make_shared<const Snapshot>());
+}
+
+std::string Cache::Directory() {
+    std::lock_guard lock(Instance().m_publishMutex);
+    return Instance().m_directory;
 }
 
-Cache::~Cache() {
-    try { save(); } catch (...) {}
+Cache::Value Cache::Read(const std::string& key) {
+    std::shared_ptr<const Snapshot> snapshot = Instance().m_snapshot.load();
+    auto entry = snapshot->find(key);
+    if (entry != snapshot->end())
+        return entry->second;
+
+    // Misses aren't remembered, other processes may create the key at any time.
+    Value value = Load(key);
+    if (!value)
+        return nullptr;
+
+    std::lock_guard lock(Instance().m_publishMutex);
+    snapshot = Instance().m_snapshot.load();
+    entry = snapshot->find(key);
+    if (entry != snapshot->end())
+        return entry->second;
+
+    // Writers publish under the same mutex, so a concurrent write is never overwritten here.
+    auto updatedSnapshot = std::make_shared<Snapshot>(*snapshot);
+    updatedSnapshot->emplace(key, value);
+    Instance().m_snapshot.store(std::move(updatedSnapshot));
+    return value;
+}
+
+void Cache::Write(const std::string& key, const std::string& value) {
+    std::string path = Path(key);
+    std::lock_guard keyLock(Instance().m_keyMutexes[std::hash<std::string>()(key) % KeyMutexCount]);
+    CreateDirectory(Directory());
+    FileLock fileLock(path + ".lock");
+    Store(key, value);
+    Publish(key, std::make_shared<const std::string>(value));
 }
 
-void Cache::save() {
-    if (m_auth == m_originalAuth)
-        return;
-    m_originalAuth = m_auth;
-
-    json authObject;
-    authObject[Objects::Auth::Authorized] = m_auth.authorized;
-    authObject[Objects::Auth::AccessToken] = m_auth.accessToken;
-    authObject[Objects::Auth::AccessTokenType] = m_auth.accessTokenType;
-    authObject[Objects::Auth::ExpiresAt] = m_auth.expiresAt;
-    authObject[Objects::Auth::RefreshToken] = m_auth.refreshToken;
-
-    json cacheJson;
-    cacheJson[Objects::Auth::Object] = authObject;
-    IO::WriteFile(CacheFile, cacheJson.dump(4) + '\n');
+Cache::Value Cache::Update(const std::string& key, const Updater& updater) {
+    std::string path = Path(key);
+    std::lock_guard keyLock(Instance().m_keyMutexes[std::hash<std::string>()(key) % KeyMutexCount]);
+    CreateDirectory(Directory());
+    FileLock fileLock(path + ".lock");
+
+    // Other processes may have changed the value since the snapshot was taken.
+    Value value = Load(key);
+    if (std::optional<std::string> updatedValue = updater(value)) {
+        Store(key, *updatedValue);
+        value = std::make_shared<const std::string>(std::move(*updatedValue));
+    }
+    Publish(key, value);
+    return value;
+}
+
+void Cache::Erase(const std::string& key) {
+    std::string path = Path(key);
+    std::lock_guard keyLock(Instance().m_keyMutexes[std::hash<std::string>()(key) % KeyMutexCount]);
+    if (fs::is_directory(Directory())) {
+        FileLock fileLock(path + ".lock");
+        std::error_code ignored;
+        fs::remove(path, ignored);
+    }
+    Publish(key, nullptr);
 }
 
 } // namespace ytcpp
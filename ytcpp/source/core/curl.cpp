@@ -1,13 +1,21 @@
 #include "ytcpp/core/curl.hpp"
 
+#include <charconv>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 
 #include <curl/curl.h>
 
 #include "ytcpp/core/error.hpp"
 #include "ytcpp/core/logger.hpp"
 #include "ytcpp/core/stopwatch.hpp"
+#include "ytcpp/context.hpp"
+#include "ytcpp/metrics.hpp"
+#include "ytcpp/yt_error.hpp"
 
 namespace ytcpp {
 
@@ -24,31 +32,106 @@ static const char* RequestName(bool noBody, bool noData) {
     return "POST";
 }
 
-Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl, const Headers& headers, bool noBody, const std::string& data) {
-    std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(), curl_easy_cleanup);
-    if (!curl)
-        throw YTCPP_LOCATED_ERROR("Couldn't initialize Curl");
+namespace Names {
+    constexpr const char* HttpRequests = "ytcpp_http_requests_total";
+    constexpr const char* HttpRequestDuration = "ytcpp_http_request_duration_seconds";
+    constexpr const char* HttpReceivedBytes = "ytcpp_http_received_bytes_total";
+    constexpr const char* HttpSentBytes = "ytcpp_http_sent_bytes_total";
+    constexpr const char* HttpRetries = "ytcpp_http_retries_total";
+}
+
+constexpr int TotalAttempts = 5;
+
+struct HttpMetrics {
+    Metrics::Counter* requests = nullptr;
+    Metrics::Histogram* duration = nullptr;
+    Metrics::Counter* receivedBytes = nullptr;
+    Metrics::Counter* sentBytes = nullptr;
+};
+
+// Host and path, query strings would make every request an endpoint of its own.
+static std::string_view RequestEndpoint(std::string_view url) {
+    size_t begin = url.find("://");
+    begin = begin == std::string_view::npos ? 0 : begin + 3;
+    size_t end = url.find('?', begin);
+    return url.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+}
+
+// Failed requests only count, their status labels never reach the other metrics.
+static const HttpMetrics& GetHttpMetrics(bool noBody, const std::string& url, const std::string& data, std::string_view status, bool failed = false) {
+    thread_local Metrics::HandleCache<HttpMetrics> cache;
+    const char* method = RequestName(noBody, data.empty());
+    std::string_view endpoint = RequestEndpoint(url);
+    return cache.get({ method, endpoint, status }, [&]() {
+        std::string endpointLabel(endpoint);
+        HttpMetrics metrics;
+        metrics.requests = &Metrics::GetCounter(Names::HttpRequests, { {"method", method}, {"endpoint", endpointLabel}, {"status", std::string(status)} });
+        if (failed)
+            return metrics;
+
+        metrics.duration = &Metrics::GetHistogram(Names::HttpRequestDuration, { {"method", method}, {"endpoint", endpointLabel} });
+        metrics.receivedBytes = &Metrics::GetCounter(Names::HttpReceivedBytes, { {"endpoint", endpointLabel} });
+        if (!data.empty())
+            metrics.sentBytes = &Metrics::GetCounter(Names::HttpSentBytes, { {"endpoint", endpointLabel} });
+        return metrics;
+    });
+}
+
+static void RecordResponse(bool noBody, const std::string& url, const std::string& data, const Curl::Response& response, uint64_t us) {
+    char status[24];
+    char* statusEnd = std::to_chars(status, status + sizeof(status), response.code).ptr;
+    const HttpMetrics& metrics = GetHttpMetrics(noBody, url, data, std::string_view(status, statusEnd - status));
+    metrics.requests->add();
+    metrics.duration->observe(us);
+    metrics.receivedBytes->add(response.headers.size() + response.data.size());
+    if (metrics.sentBytes)
+        metrics.sentBytes->add(data.size());
+}
+
+static void RecordFailure(bool noBody, const std::string& url, const std::string& data, const char* status) {
+    GetHttpMetrics(noBody, url, data, status, true).requests->add();
+}
+
+static void RecordRetry(const std::string& url) {
+    Metrics::GetCounter(Names::HttpRetries, { {"endpoint", std::string(RequestEndpoint(url))} }).add();
+}
+
+using HeaderList = std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)>;
+
+static HeaderList MakeHeaderList(const Curl::Headers& headers) {
+    HeaderList slist(nullptr, curl_slist_free_all);
+    for (const std::string& header : headers) {
+        curl_slist* oldList = slist.release();
+        curl_slist* newList = curl_slist_append(oldList, header.c_str());
+        if (!newList) {
+            curl_slist_free_all(oldList);
+            throw YTCPP_LOCATED_ERROR("Couldn't append to request headers list");
+        }
+        slist.reset(newList);
+    }
+    return slist;
+}
 
-    CURLcode result = curl_easy_setopt(curl.get(), CURLOPT_BUFFERSIZE, 102400);
+static void Configure(CURL* curl, const std::string& url, const std::string& proxyUrl, curl_slist* headers, bool noBody, const std::string& data, Curl::Response& response) {
+    CURLcode result = curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 50);
     if (result) {
         throw YTCPP_LOCATED_ERROR(
-            "Couldn't configure request buffer size (libcurl error: {}, \"{}\")",
+            "Couldn't configure request max redirections (libcurl error: {}, \"{}\")",
             static_cast<std::underlying_type<CURLcode>::type>(result),
             curl_easy_strerror(result)
         );
     }
 
-    result = curl_easy_setopt(curl.get(), CURLOPT_MAXREDIRS, 50);
+    result = curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, 102400L);
     if (result) {
         throw YTCPP_LOCATED_ERROR(
-            "Couldn't configure request max redirections (libcurl error: {}, \"{}\")",
+            "Couldn't configure request buffer size (libcurl error: {}, \"{}\")",
             static_cast<std::underlying_type<CURLcode>::type>(result),
             curl_easy_strerror(result)
         );
     }
 
-
-    result = curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+    result = curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
     if (result) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't configure request URL (libcurl error: {}, \"{}\")",
@@ -57,7 +140,7 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
         );
     }
 
-    result = curl_easy_setopt(curl.get(), CURLOPT_PROXY, proxyUrl.c_str());
+    result = curl_easy_setopt(curl, CURLOPT_PROXY, proxyUrl.c_str());
     if (result) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't configure request proxy URL (libcurl error: {}, \"{}\")",
@@ -66,7 +149,7 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
         );
     }
 
-    result = curl_easy_setopt(curl.get(), CURLOPT_NOBODY, static_cast<long>(noBody));
+    result = curl_easy_setopt(curl, CURLOPT_NOBODY, static_cast<long>(noBody));
     if (result) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't configure request body download policy (libcurl error: {}, \"{}\")",
@@ -75,8 +158,7 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
         );
     }
 
-    Curl::Response response = {};
-    result = curl_easy_setopt(curl.get(), CURLOPT_HEADERDATA, &response.headers);
+    result = curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response.headers);
     if (result) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't configure response headers write target (libcurl error: {}, \"{}\")",
@@ -85,7 +167,7 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
         );
     }
 
-    result = curl_easy_setopt(curl.get(), CURLOPT_HEADERFUNCTION, &StringWriter);
+    result = curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, &StringWriter);
     if (result) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't configure response headers write function (libcurl error: {}, \"{}\")",
@@ -94,7 +176,7 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
         );
     }
 
-    result = curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &response.data);
+    result = curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response.data);
     if (result) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't configure response data write target (libcurl error: {}, \"{}\")",
@@ -103,7 +185,7 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
         );
     }
 
-    result = curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, &StringWriter);
+    result = curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &StringWriter);
     if (result) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't configure response data write function (libcurl error: {}, \"{}\")",
@@ -112,19 +194,8 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
         );
     }
 
-    std::unique_ptr<curl_slist, decltype(&curl_slist_free_all)> slist(nullptr, curl_slist_free_all);
-    if (!headers.empty()) {
-        for (const std::string& header : headers) {
-            curl_slist* oldList = slist.release();
-            curl_slist* newList = curl_slist_append(oldList, header.c_str());
-            if (!newList) {
-                curl_slist_free_all(oldList);
-                throw YTCPP_LOCATED_ERROR("Couldn't append to request headers list");
-            }
-            slist.reset(newList);
-        }
-
-        result = curl_easy_setopt(curl.get(), CURLOPT_HTTPHEADER, slist.get());
+    if (headers) {
+        result = curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
         if (result) {
             throw YTCPP_LOCATED_ERROR(
                 "Couldn't configure request headers (libcurl error: {}, \"{}\")",
@@ -135,7 +206,7 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
     }
 
     if (!data.empty()) {
-        result = curl_easy_setopt(curl.get(), CURLOPT_POSTFIELDS, data.c_str());
+        result = curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str());
         if (result) {
             throw YTCPP_LOCATED_ERROR(
                 "Couldn't configure request post data (libcurl error: {}, \"{}\")",
@@ -144,15 +215,411 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
             );
         }
     }
+}
+
+// Drives every asynchronous transfer of a context from a single thread through a curl multi handle.
+class Curl::Engine {
+private:
+    struct Transfer {
+        uint64_t id = 0;
+        CURL* handle = nullptr;
+        HeaderList headers = { nullptr, curl_slist_free_all };
+        std::string url;
+        bool noBody = false;
+        std::string data;
+        Response response;
+        int attempt = 1;
+        Stopwatch stopwatch;
+        Completion completion;
+    };
+
+private:
+    Curl& m_owner;
+    Context& m_context;
+    CURLM* m_multi = nullptr;
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<Transfer>> m_starting;
+    std::vector<uint64_t> m_cancelling;
+    bool m_closed = false;
+    bool m_stopping = false;
+    uint64_t m_nextId = 1;
+    std::unordered_map<uint64_t, std::unique_ptr<Transfer>> m_transfers;
+    std::thread m_thread;
+
+public:
+    Engine(Curl& owner, Context& context);
+
+    Engine(const Engine&) = delete;
+
+    ~Engine();
+
+public:
+    Engine& operator=(const Engine&) = delete;
+
+public:
+    uint64_t start(const std::string& url, const std::string& proxyUrl, const Headers& headers, bool noBody, const std::string& data, Completion completion);
+
+    void cancel(uint64_t id);
+
+    // Fails every request in flight and every later one.
+    void close();
+
+private:
+    void run();
+
+    void stopTransfers();
+
+    void finish(Transfer& transfer, CURLcode result);
+
+    void complete(uint64_t id, std::exception_ptr error);
+};
+
+Curl::Engine::Engine(Curl& owner, Context& context)
+    : m_owner(owner)
+    , m_context(context)
+    , m_multi(curl_multi_init()) {
+    if (!m_multi)
+        throw YTCPP_LOCATED_ERROR("Couldn't initialize Curl multi handle");
+    m_thread = std::thread(&Engine::run, this);
+}
+
+Curl::Engine::~Engine() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    curl_multi_wakeup(m_multi);
+    m_thread.join();
+    curl_multi_cleanup(m_multi);
+}
+
+uint64_t Curl::Engine::start(const std::string& url, const std::string& proxyUrl, const Headers& headers, bool noBody, const std::string& data, Completion completion) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->headers = MakeHeaderList(headers);
+    transfer->url = url;
+    transfer->noBody = noBody;
+    transfer->data = data;
+    transfer->completion = std::move(completion);
+    transfer->handle = static_cast<CURL*>(m_owner.acquireHandle());
+    try {
+        Configure(transfer->handle, transfer->url, proxyUrl, transfer->headers.get(), noBody, transfer->data, transfer->response);
+        CURLcode result = curl_easy_setopt(transfer->handle, CURLOPT_PRIVATE, transfer.get());
+        if (result) {
+            throw YTCPP_LOCATED_ERROR(
+                "Couldn't configure request private data (libcurl error: {}, \"{}\")",
+                static_cast<std::underlying_type<CURLcode>::type>(result),
+                curl_easy_strerror(result)
+            );
+        }
+    }
+    catch (...) {
+        m_owner.releaseHandle(transfer->handle);
+        throw;
+    }
+
+    uint64_t id = 0;
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_closed) {
+            id = transfer->id = m_nextId++;
+            m_starting.push_back(std::move(transfer));
+        }
+    }
+    if (transfer) {
+        m_owner.releaseHandle(transfer->handle);
+        throw YtError(YtError::Type::Cancelled, "Request engine stopped");
+    }
+    curl_multi_wakeup(m_multi);
+    return id;
+}
+
+void Curl::Engine::cancel(uint64_t id) {
+    {
+        std::lock_guard lock(m_mutex);
+        m_cancelling.push_back(id);
+    }
+    curl_multi_wakeup(m_multi);
+}
+
+void Curl::Engine::close() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_closed = true;
+    }
+    curl_multi_wakeup(m_multi);
+}
+
+void Curl::Engine::run() {
+    Context::Scope scope(m_context);
+    while (true) {
+        std::vector<std::unique_ptr<Transfer>> starting;
+        std::vector<uint64_t> cancelling;
+        bool closed = false;
+        {
+            std::lock_guard lock(m_mutex);
+            starting.swap(m_starting);
+            cancelling.swap(m_cancelling);
+            if (m_stopping) {
+                for (std::unique_ptr<Transfer>& transfer : starting)
+                    m_transfers.emplace(transfer->id, std::move(transfer));
+                break;
+            }
+            closed = m_closed;
+        }
+        if (closed) {
+            for (std::unique_ptr<Transfer>& transfer : starting)
+                m_transfers.emplace(transfer->id, std::move(transfer));
+            stopTransfers();
+            curl_multi_poll(m_multi, nullptr, 0, 1000, nullptr);
+            continue;
+        }
+
+        for (std::unique_ptr<Transfer>& transfer : starting) {
+            uint64_t id = transfer->id;
+            CURLMcode result = curl_multi_add_handle(m_multi, transfer->handle);
+            m_transfers.emplace(id, std::move(transfer));
+            if (result) {
+                complete(id, std::make_exception_ptr(YTCPP_LOCATED_ERROR(
+                    "Couldn't start request (libcurl error: {}, \"{}\")",
+                    static_cast<std::underlying_type<CURLMcode>::type>(result),
+                    curl_multi_strerror(result)
+                )));
+            }
+        }
+        for (uint64_t id : cancelling) {
+            auto transfer = m_transfers.find(id);
+            if (transfer == m_transfers.end())
+                continue;
+            RecordFailure(transfer->second->noBody, transfer->second->url, transfer->second->data, "cancelled");
+            complete(id, std::make_exception_ptr(YtError(YtError::Type::Cancelled, "Request cancelled")));
+        }
+
+        int running = 0;
+        curl_multi_perform(m_multi, &running);
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(m_multi, &queued)) {
+            if (message->msg != CURLMSG_DONE)
+                continue;
+            CURL* handle = message->easy_handle;
+            CURLcode result = message->data.result;
+            Transfer* transfer = nullptr;
+            curl_easy_getinfo(handle, CURLINFO_PRIVATE, &transfer);
+            finish(*transfer, result);
+        }
+
+        curl_multi_poll(m_multi, nullptr, 0, 1000, nullptr);
+    }
+    stopTransfers();
+}
+
+void Curl::Engine::stopTransfers() {
+    std::vector<uint64_t> remaining;
+    for (const auto& [id, transfer] : m_transfers)
+        remaining.push_back(id);
+    for (uint64_t id : remaining)
+        complete(id, std::make_exception_ptr(YtError(YtError::Type::Cancelled, "Request engine stopped")));
+}
+
+void Curl::Engine::finish(Transfer& transfer, CURLcode result) {
+    if (result) {
+        if (transfer.attempt < TotalAttempts) {
+            ++transfer.attempt;
+            RecordRetry(transfer.url);
+            Logger::Warn(
+                "Request attempt failed (libcurl error: {}, \"{}\"), retrying...",
+                static_cast<std::underlying_type<CURLcode>::type>(result),
+                curl_easy_strerror(result)
+            );
+            curl_multi_remove_handle(m_multi, transfer.handle);
+            transfer.response = {};
+            curl_multi_add_handle(m_multi, transfer.handle);
+            return;
+        }
+
+        RecordFailure(transfer.noBody, transfer.url, transfer.data, "error");
+        complete(transfer.id, std::make_exception_ptr(YTCPP_LOCATED_ERROR(
+            "Couldn't perform request in {} attempts (libcurl error: {}, \"{}\")",
+            TotalAttempts, static_cast<std::underlying_type<CURLcode>::type>(result),
+            curl_easy_strerror(result)
+        )));
+        return;
+    }
+    transfer.stopwatch.stop();
+
+    result = curl_easy_getinfo(transfer.handle, CURLINFO_RESPONSE_CODE, &transfer.response.code);
+    if (result) {
+        complete(transfer.id, std::make_exception_ptr(YTCPP_LOCATED_ERROR(
+            "Couldn't retrieve response code (libcurl error: {}, \"{}\")",
+            static_cast<std::underlying_type<CURLcode>::type>(result),
+            curl_easy_strerror(result)
+        )));
+        return;
+    }
+
+    RecordResponse(transfer.noBody, transfer.url, transfer.data, transfer.response, transfer.stopwatch.us());
+    Logger::Debug("[{}] ({} ms) {} {}", transfer.response.code, transfer.stopwatch.ms(), RequestName(transfer.noBody, transfer.data.empty()), transfer.url);
+    complete(transfer.id, nullptr);
+}
+
+void Curl::Engine::complete(uint64_t id, std::exception_ptr error) {
+    auto node = m_transfers.extract(id);
+    if (!node)
+        return;
+
+    Transfer& transfer = *node.mapped();
+    curl_multi_remove_handle(m_multi, transfer.handle);
+    m_owner.releaseHandle(transfer.handle);
+    try {
+        transfer.completion(std::move(transfer.response), error);
+    }
+    catch (const std::exception& error) {
+        Logger::Warn("Couldn't deliver request completion ({})", error.what());
+    }
+}
+
+struct Curl::Operation::State {
+    Context* context = nullptr;
+    std::string url;
+    Headers headers;
+    bool noBody = false;
+    std::string data;
+    std::stop_token stopToken;
+    std::coroutine_handle<> handle;
+    Response response;
+    std::exception_ptr error;
+    // Guards the stop callback, which is registered after the request starts and removed once it completes.
+    std::mutex mutex;
+    std::optional<std::stop_callback<std::function<void()>>> stopCallback;
+    // Held from suspension until the coroutine was resumed, the context can't go away in between.
+    std::optional<Context::Work> work;
+};
+
+Curl::Operation::Operation(const std::string& url, const Headers& headers, bool noBody, const std::string& data, std::stop_token stopToken)
+    : m_state(std::make_shared<State>()) {
+    m_state->context = &Context::Current();
+    m_state->url = url;
+    m_state->headers = headers;
+    m_state->noBody = noBody;
+    m_state->data = data;
+    m_state->stopToken = std::move(stopToken);
+}
+
+bool Curl::Operation::await_suspend(std::coroutine_handle<> handle) {
+    std::shared_ptr<State> state = m_state;
+    if (state->stopToken.stop_requested()) {
+        state->error = std::make_exception_ptr(YtError(YtError::Type::Cancelled, "Request cancelled"));
+        return false;
+    }
+
+    state->handle = handle;
+    Context::Scope scope(*state->context);
+    std::lock_guard lock(state->mutex);
+    state->work.emplace(*state->context);
+    try {
+        Engine& engine = Instance().engine();
+        uint64_t id = engine.start(state->url, GetProxyUrl(), state->headers, state->noBody, state->data, [state](Response&& response, std::exception_ptr error) {
+            std::lock_guard lock(state->mutex);
+            // Waits for a concurrently running callback, the engine isn't referenced after completion.
+            state->stopCallback.reset();
+            state->response = std::move(response);
+            state->error = error;
+            state->context->executor()->post([state, work = std::move(*state->work)]() {
+                Context::Scope scope(*state->context);
+                state->handle.resume();
+            });
+        });
+
+        // The engine outlives the callback, ~Context waits for the work taken above.
+        state->stopCallback.emplace(state->stopToken, [&engine, id]() {
+            engine.cancel(id);
+        });
+    }
+    catch (...) {
+        state->work.reset();
+        throw;
+    }
+    return true;
+}
+
+Curl::Response Curl::Operation::await_resume() {
+    if (m_state->error)
+        std::rethrow_exception(m_state->error);
+    return std::move(m_state->response);
+}
+
+Curl::Curl() = default;
+
+Curl::~Curl() {
+    m_engine.reset();
+    for (void* handle : m_idleHandles)
+        curl_easy_cleanup(handle);
+}
+
+// Idle handles keep their connection and DNS caches, so later requests can reuse open connections.
+void* Curl::acquireHandle() {
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_idleHandles.empty()) {
+            void* handle = m_idleHandles.back();
+            m_idleHandles.pop_back();
+            return handle;
+        }
+    }
+    CURL* handle = curl_easy_init();
+    if (!handle)
+        throw YTCPP_LOCATED_ERROR("Couldn't initialize Curl");
+
+    return handle;
+}
+
+void Curl::releaseHandle(void* handle) {
+    curl_easy_reset(handle);
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_idleHandles.size() < MaxIdleHandles) {
+            m_idleHandles.push_back(handle);
+            return;
+        }
+    }
+    curl_easy_cleanup(handle);
+}
+
+Curl::Engine& Curl::engine() {
+    std::lock_guard lock(m_mutex);
+    if (!m_engine) {
+        if (m_closed)
+            throw YtError(YtError::Type::Cancelled, "Request engine stopped");
+        m_engine = std::make_unique<Engine>(*this, Context::Current());
+    }
+    return *m_engine;
+}
+
+void Curl::close() {
+    std::lock_guard lock(m_mutex);
+    m_closed = true;
+    if (m_engine)
+        m_engine->close();
+}
+
+Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl, const Headers& headers, bool noBody, const std::string& data) {
+    Curl& owner = Instance();
+    auto releaseHandle = [&owner](CURL* handle) {
+        owner.releaseHandle(handle);
+    };
+    std::unique_ptr<CURL, decltype(releaseHandle)> curl(owner.acquireHandle(), releaseHandle);
+    HeaderList headerList = MakeHeaderList(headers);
+    Curl::Response response = {};
+    Configure(curl.get(), url, proxyUrl, headerList.get(), noBody, data, response);
 
     Stopwatch stopwatch;
-    constexpr int TotalAttempts = 5;
+    CURLcode result = CURLE_OK;
     for (int attempt = 1; true; ++attempt) {
         result = curl_easy_perform(curl.get());
         if (!result)
             break;
 
         if (attempt < TotalAttempts) {
+            RecordRetry(url);
             Logger::Warn(
                 "Request attempt failed (libcurl error: {}, \"{}\"), retrying...",
                 static_cast<std::underlying_type<CURLcode>::type>(result),
@@ -161,6 +628,7 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
             continue;
         }
 
+        RecordFailure(noBody, url, data, "error");
         throw YTCPP_LOCATED_ERROR(
             "Couldn't perform request in {} attempts (libcurl error: {}, \"{}\")",
             TotalAttempts, static_cast<std::underlying_type<CURLcode>::type>(result),
@@ -178,6 +646,7 @@ Curl::Response Curl::Request(const std::string& url, const std::string& proxyUrl
         );
     }
 
+    RecordResponse(noBody, url, data, response, stopwatch.us());
     Logger::Debug("[{}] ({} ms) {} {}", response.code, stopwatch.ms(), RequestName(noBody, data.empty()), url);
     return response;
 }
@@ -0,0 +1,94 @@
+#include "ytcpp/core/executor.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include "ytcpp/core/logger.hpp"
+
+namespace ytcpp {
+
+static thread_local const ThreadPool* CurrentPool = nullptr;
+static thread_local size_t CurrentQueue = 0;
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    threadCount = std::max<size_t>(threadCount, 1);
+    m_queues.reserve(threadCount);
+    for (size_t index = 0; index < threadCount; ++index)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    m_threads.reserve(threadCount);
+    for (size_t index = 0; index < threadCount; ++index)
+        m_threads.emplace_back(&ThreadPool::run, this, index);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+// Workers take their own newest tasks first and steal the oldest ones from the others.
+bool ThreadPool::pop(size_t index, Task& task) {
+    for (size_t offset = 0; offset < m_queues.size(); ++offset) {
+        Queue& queue = *m_queues[(index + offset) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+
+        if (offset == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        m_pending.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t index) {
+    CurrentPool = this;
+    CurrentQueue = index;
+    while (true) {
+        Task task;
+        if (pop(index, task)) {
+            try {
+                task();
+            }
+            catch (const std::exception& error) {
+                Logger::Error("Thread pool task failed ({})", error.what());
+            }
+            continue;
+        }
+
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this]() {
+            return m_stopping || m_pending.load() != 0;
+        });
+        if (m_stopping && m_pending.load() == 0)
+            return;
+    }
+}
+
+void ThreadPool::post(Task task) {
+    // Tasks posted by a worker stay on its queue, others are spread round-robin.
+    size_t index = CurrentPool == this ? CurrentQueue : m_nextQueue.fetch_add(1) % m_queues.size();
+    m_pending.fetch_add(1);
+    {
+        std::lock_guard lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(m_mutex);
+    }
+    m_condition.notify_one();
+}
+
+} // namespace ytcpp
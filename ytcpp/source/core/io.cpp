@@ -8,14 +8,17 @@
 namespace ytcpp {
     
 void IO::WriteFile(const std::string& fileName, const std::string& contents) {
-    std::ofstream file(fileName, std::ios::trunc);
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
     if (!file)
         throw YTCPP_LOCATED_ERROR("Couldn't create/open \"{}\" file", fileName);
     file << contents;
+    file.flush();
+    if (!file)
+        throw YTCPP_LOCATED_ERROR("Couldn't write \"{}\" file", fileName);
 }
 
 std::string IO::ReadFile(const std::string& fileName) {
-    std::ifstream file(fileName);
+    std::ifstream file(fileName, std::ios::binary);
     if (!file)
         throw YTCPP_LOCATED_ERROR("Couldn't open \"{}\" file", fileName);
 
@@ -1,31 +1,98 @@
 #include "ytcpp/core/js.hpp"
 
 #include "ytcpp/core/error.hpp"
+#include "ytcpp/core/hash.hpp"
+#include "ytcpp/core/logger.hpp"
 
 namespace ytcpp {
 
-Js::Interpreter::Interpreter()
-    : m_context(nullptr, &duk_destroy_heap) {
+std::atomic<uint64_t> Js::Interpreter::EvaluationCount = 0;
+
+Js::Interpreter::Interpreter(const Limits& limits)
+    : m_limits(limits) {
     reset();
 }
 
+const std::string& Js::Interpreter::EngineFingerprint() {
+    // Serialized bytecode depends on engine build options, dumping a fixed probe captures them.
+    static const std::string fingerprint = [] {
+        Engine::Instance engine = Engine::Create(0);
+        std::string probe = engine->compile("var probe = function(a) { return [a, 1.5, 'b', { c: a }].join(); };");
+        return fmt::format("{}-{}bit-{:016x}", Engine::Version(), sizeof(void*) * 8, Hash::Fnv1a(probe));
+    }();
+    return fingerprint;
+}
+
+Js::Interpreter& Js::Interpreter::operator=(Interpreter&& other) noexcept {
+    // The old heap goes first, as a whole, so it never outlives the allocator it runs on.
+    m_engine.reset();
+    m_limits = other.m_limits;
+    m_engine = std::move(other.m_engine);
+    m_prelude = std::move(other.m_prelude);
+    m_resets = other.m_resets;
+    return *this;
+}
+
 std::string Js::Interpreter::execute(const std::string& code) {
-    if (!m_context) {
-        // Somebody used std::move() and invalidated the context!
+    if (!m_engine) {
+        // Somebody used std::move() and invalidated the engine!
         reset();
     }
 
-    duk_int_t error = duk_peval_string(m_context.get(), code.c_str());
-    std::string result = duk_safe_to_string(m_context.get(), -1);
-    if (error)
-        throw Js::Error(result);
-    return result;
+    EvaluationCount.fetch_add(1, std::memory_order_relaxed);
+    try {
+        std::string result = m_engine->execute(code);
+        checkMemory();
+        return result;
+    }
+    catch (const Js::Error&) {
+        checkMemory();
+        throw;
+    }
+}
+
+std::string Js::Interpreter::compile(const std::string& code) {
+    if (!m_engine)
+        reset();
+    return m_engine->compile(code);
+}
+
+void Js::Interpreter::load(const std::string& bytecode) {
+    if (!m_engine)
+        reset();
+
+    EvaluationCount.fetch_add(1, std::memory_order_relaxed);
+    m_engine->load(bytecode);
+    m_prelude.push_back(bytecode);
 }
 
 void Js::Interpreter::reset() {
-    m_context.reset(duk_create_heap_default());
-    if (!m_context)
-        throw YTCPP_LOCATED_ERROR("Couldn't allocate JS interpreter state");
+    // Old engine must release its memory before the new one is created.
+    m_engine.reset();
+    m_engine = Engine::Create(m_limits.maxBytes);
+
+    // Loaded bytecode is part of interpreter state and survives resets.
+    std::vector<std::string> prelude = std::move(m_prelude);
+    m_prelude.clear();
+    for (const std::string& bytecode : prelude)
+        load(bytecode);
+}
+
+void Js::Interpreter::checkMemory() {
+    // Measuring the heap isn't free with every engine, skip it when nothing uses it.
+    if (!m_limits.resetBytes)
+        return;
+
+    size_t currentBytes = m_engine->memory().currentBytes;
+    if (currentBytes <= m_limits.resetBytes)
+        return;
+
+    Logger::Debug(
+        "JS interpreter heap reached {} bytes (reset threshold: {} bytes), resetting",
+        currentBytes, m_limits.resetBytes
+    );
+    reset();
+    ++m_resets;
 }
 
 } // namespace ytcpp
@@ -0,0 +1,92 @@
+#include "ytcpp/core/js.hpp"
+
+#include <cstring>
+
+#include <duktape.h>
+
+#include "ytcpp/core/error.hpp"
+
+namespace ytcpp {
+
+static void* Allocate(void* arena, duk_size_t size) {
+    return static_cast<Arena*>(arena)->allocate(size);
+}
+
+static void* Reallocate(void* arena, void* pointer, duk_size_t size) {
+    return static_cast<Arena*>(arena)->reallocate(pointer, size);
+}
+
+static void Deallocate(void* arena, void* pointer) {
+    static_cast<Arena*>(arena)->deallocate(pointer);
+}
+
+static duk_ret_t LoadBytecode(duk_context* context, void* bytecode) {
+    const std::string& source = *static_cast<const std::string*>(bytecode);
+    void* buffer = duk_push_fixed_buffer(context, source.size());
+    std::memcpy(buffer, source.data(), source.size());
+    duk_load_function(context);
+    duk_call(context, 0);
+    return 1;
+}
+
+class DuktapeEngine : public Js::Engine {
+private:
+    std::unique_ptr<Arena> m_arena;
+    std::unique_ptr<duk_context, decltype(&duk_destroy_heap)> m_context;
+
+public:
+    DuktapeEngine(size_t maxBytes)
+        : m_arena(std::make_unique<Arena>(maxBytes))
+        , m_context(duk_create_heap(&Allocate, &Reallocate, &Deallocate, m_arena.get(), nullptr), &duk_destroy_heap) {
+        if (!m_context)
+            throw YTCPP_LOCATED_ERROR("Couldn't allocate JS interpreter state");
+    }
+
+public:
+    std::string execute(const std::string& code) override {
+        duk_int_t error = duk_peval_lstring(m_context.get(), code.data(), code.size());
+        std::string result = duk_safe_to_string(m_context.get(), -1);
+        duk_pop(m_context.get());
+        if (error)
+            throw Js::Error(result);
+        return result;
+    }
+
+    std::string compile(const std::string& code) override {
+        duk_context* context = m_context.get();
+        if (duk_pcompile_lstring(context, 0, code.data(), code.size())) {
+            std::string error = duk_safe_to_string(context, -1);
+            duk_pop(context);
+            throw Js::Error(error);
+        }
+
+        duk_dump_function(context);
+        duk_size_t size = 0;
+        const char* data = static_cast<const char*>(duk_get_buffer_data(context, -1, &size));
+        std::string bytecode(data, size);
+        duk_pop(context);
+        return bytecode;
+    }
+
+    void load(const std::string& bytecode) override {
+        duk_int_t error = duk_safe_call(m_context.get(), &LoadBytecode, const_cast<std::string*>(&bytecode), 0, 1);
+        std::string result = duk_safe_to_string(m_context.get(), -1);
+        duk_pop(m_context.get());
+        if (error)
+            throw Js::Error(result);
+    }
+
+    Arena::Stats memory() const override {
+        return m_arena->stats();
+    }
+};
+
+std::string Js::Engine::Version() {
+    return fmt::format("duktape-{}", DUK_VERSION);
+}
+
+Js::Engine::Instance Js::Engine::Create(size_t maxBytes) {
+    return std::make_unique<DuktapeEngine>(maxBytes);
+}
+
+} // namespace ytcpp
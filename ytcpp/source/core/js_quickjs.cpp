@@ -0,0 +1,116 @@
+#include "ytcpp/core/js.hpp"
+
+#include <algorithm>
+
+#include <quickjs.h>
+
+#include "ytcpp/core/error.hpp"
+
+#ifndef YTCPP_QUICKJS_VERSION
+#define YTCPP_QUICKJS_VERSION "unknown"
+#endif
+
+namespace ytcpp {
+
+class QuickJsEngine : public Js::Engine {
+private:
+    std::unique_ptr<JSRuntime, decltype(&JS_FreeRuntime)> m_runtime;
+    std::unique_ptr<JSContext, decltype(&JS_FreeContext)> m_context;
+    mutable size_t m_peakBytes = 0;
+
+public:
+    QuickJsEngine(size_t maxBytes)
+        : m_runtime(JS_NewRuntime(), &JS_FreeRuntime)
+        , m_context(nullptr, &JS_FreeContext) {
+        if (!m_runtime)
+            throw YTCPP_LOCATED_ERROR("Couldn't allocate JS runtime");
+        if (maxBytes)
+            JS_SetMemoryLimit(m_runtime.get(), maxBytes);
+
+        m_context.reset(JS_NewContext(m_runtime.get()));
+        if (!m_context)
+            throw YTCPP_LOCATED_ERROR("Couldn't allocate JS interpreter state");
+    }
+
+private:
+    std::string toString(JSValueConst value) const {
+        const char* string = JS_ToCString(m_context.get(), value);
+        if (!string)
+            return "<unconvertible value>";
+
+        std::string result = string;
+        JS_FreeCString(m_context.get(), string);
+        return result;
+    }
+
+    std::string consume(JSValue value) const {
+        if (JS_IsException(value)) {
+            JSValue exception = JS_GetException(m_context.get());
+            std::string message = toString(exception);
+            JS_FreeValue(m_context.get(), exception);
+            throw Js::Error(message);
+        }
+
+        std::string result = toString(value);
+        JS_FreeValue(m_context.get(), value);
+        return result;
+    }
+
+public:
+    std::string execute(const std::string& code) override {
+        return consume(JS_Eval(m_context.get(), code.c_str(), code.size(), "<eval>", JS_EVAL_TYPE_GLOBAL));
+    }
+
+    std::string compile(const std::string& code) override {
+        JSValue function = JS_Eval(m_context.get(), code.c_str(), code.size(), "<player>", JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+        if (JS_IsException(function))
+            consume(function);
+
+        size_t size = 0;
+        uint8_t* data = JS_WriteObject(m_context.get(), &size, function, JS_WRITE_OBJ_BYTECODE);
+        JS_FreeValue(m_context.get(), function);
+        if (!data)
+            throw Js::Error("Couldn't serialize compiled code");
+
+        std::string bytecode(reinterpret_cast<const char*>(data), size);
+        js_free(m_context.get(), data);
+        return bytecode;
+    }
+
+    void load(const std::string& bytecode) override {
+        JSValue function = JS_ReadObject(
+            m_context.get(), reinterpret_cast<const uint8_t*>(bytecode.data()),
+            bytecode.size(), JS_READ_OBJ_BYTECODE
+        );
+        if (JS_IsException(function))
+            consume(function);
+        consume(JS_EvalFunction(m_context.get(), function));
+    }
+
+    Arena::Stats memory() const override {
+        JSMemoryUsage usage = {};
+        JS_ComputeMemoryUsage(m_runtime.get(), &usage);
+
+        Arena::Stats stats;
+        stats.currentBytes = static_cast<size_t>(usage.malloc_size);
+        stats.reservedBytes = static_cast<size_t>(usage.memory_used_size);
+        stats.allocations = static_cast<uint64_t>(usage.malloc_count);
+        m_peakBytes = std::max(m_peakBytes, stats.currentBytes);
+        stats.peakBytes = m_peakBytes;
+        return stats;
+    }
+};
+
+std::string Js::Engine::Version() {
+#ifdef QJS_VERSION_MAJOR
+    return fmt::format("quickjs-ng-{}.{}.{}", QJS_VERSION_MAJOR, QJS_VERSION_MINOR, QJS_VERSION_PATCH);
+#else
+    return fmt::format("quickjs-{}", YTCPP_QUICKJS_VERSION);
+#endif
+}
+
+Js::Engine::Instance Js::Engine::Create(size_t maxBytes) {
+    return std::make_unique<QuickJsEngine>(maxBytes);
+}
+
+} // namespace ytcpp
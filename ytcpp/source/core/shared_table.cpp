@@ -0,0 +1,225 @@
+#include "ytcpp/core/shared_table.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ytcpp/core/error.hpp"
+#include "ytcpp/core/logger.hpp"
+
+namespace ytcpp {
+
+namespace Layout {
+    constexpr uint64_t Magic = 0x3154485350435459; // "YTCPSHT1"
+    constexpr size_t ProbeCount = 8;
+    constexpr size_t ReadAttempts = 4;
+    constexpr size_t WriteAttempts = 4;
+}
+
+struct SharedTable::Header {
+    std::atomic<uint64_t> magic;
+    uint64_t slotCount;
+    char reserved[48];
+};
+
+struct SharedTable::Slot {
+    std::atomic<uint32_t> sequence;
+    uint16_t keyLength;
+    uint16_t valueLength;
+    uint64_t hash;
+    char key[MaxKeySize];
+    char value[MaxValueSize];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free);
+
+static uint64_t HashKey(std::string_view key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char character : key) {
+        hash ^= static_cast<uint8_t>(character);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+#ifndef _WIN32
+
+static std::string ObjectName(const std::string& name) {
+    return name.starts_with('/') ? name : '/' + name;
+}
+
+SharedTable::SharedTable(const std::string& name, size_t slotCount)
+    : m_name(ObjectName(name)) {
+    if (slotCount == 0)
+        throw YTCPP_LOCATED_ERROR("Shared table \"{}\" needs at least one slot", m_name);
+    slotCount = std::bit_ceil(slotCount);
+
+    int file = shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (file < 0)
+        throw YTCPP_LOCATED_ERROR("Couldn't create/open \"{}\" shared memory object ({})", m_name, std::strerror(errno));
+
+    // Only the first process sizes the object, everyone else adopts its geometry.
+    while (flock(file, LOCK_EX) != 0 && errno == EINTR);
+    struct stat status = {};
+    bool failed = fstat(file, &status) != 0;
+    if (!failed && status.st_size == 0) {
+        status.st_size = static_cast<off_t>(sizeof(Header) + slotCount * sizeof(Slot));
+        failed = ftruncate(file, status.st_size) != 0;
+    }
+    if (!failed) {
+        m_size = static_cast<size_t>(status.st_size);
+        void* address = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        failed = address == MAP_FAILED;
+        if (!failed)
+            m_header = static_cast<Header*>(address);
+    }
+    // A zero-filled object is a valid empty table, only the header needs stamping.
+    if (!failed && m_size >= sizeof(Header) && m_header->magic.load(std::memory_order_acquire) == 0) {
+        m_header->slotCount = (m_size - sizeof(Header)) / sizeof(Slot);
+        m_header->magic.store(Layout::Magic, std::memory_order_release);
+    }
+    int error = errno;
+    flock(file, LOCK_UN);
+    close(file);
+    if (failed)
+        throw YTCPP_LOCATED_ERROR("Couldn't map \"{}\" shared memory object ({})", m_name, std::strerror(error));
+
+    uint64_t actualSlotCount = m_size < sizeof(Header) ? 0 : m_header->slotCount;
+    if (actualSlotCount == 0 || m_header->magic.load(std::memory_order_acquire) != Layout::Magic || !std::has_single_bit(actualSlotCount)
+        || sizeof(Header) + actualSlotCount * sizeof(Slot) > m_size) {
+        munmap(m_header, m_size);
+        throw YTCPP_LOCATED_ERROR("Shared memory object \"{}\" isn't a shared table", m_name);
+    }
+    if (actualSlotCount != slotCount)
+        Logger::Debug("Shared table \"{}\": Using existing geometry ({} slots instead of {})", m_name, actualSlotCount, slotCount);
+
+    m_slots = reinterpret_cast<Slot*>(m_header + 1);
+    m_mask = actualSlotCount - 1;
+}
+
+SharedTable::~SharedTable() {
+    munmap(m_header, m_size);
+}
+
+void SharedTable::Unlink(const std::string& name) {
+    std::string objectName = ObjectName(name);
+    if (shm_unlink(objectName.c_str()) != 0 && errno != ENOENT)
+        throw YTCPP_LOCATED_ERROR("Couldn't unlink \"{}\" shared memory object ({})", objectName, std::strerror(errno));
+}
+
+#else
+
+SharedTable::SharedTable(const std::string& name, size_t)
+    : m_name(name) {
+    throw YTCPP_LOCATED_ERROR("Shared tables aren't supported on this platform");
+}
+
+SharedTable::~SharedTable() = default;
+
+void SharedTable::Unlink(const std::string&) {}
+
+#endif
+
+std::optional<std::string> SharedTable::get(std::string_view key) const {
+    if (key.size() > MaxKeySize) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    uint64_t hash = HashKey(key);
+    for (size_t probe = 0; probe < Layout::ProbeCount; ++probe) {
+        const Slot& slot = m_slots[(hash + probe) & m_mask];
+        for (size_t attempt = 0; attempt < Layout::ReadAttempts; ++attempt) {
+            uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1)
+                continue;
+
+            uint64_t slotHash = slot.hash;
+            size_t keyLength = std::min<size_t>(slot.keyLength, MaxKeySize);
+            size_t valueLength = std::min<size_t>(slot.valueLength, MaxValueSize);
+            char slotKey[MaxKeySize], value[MaxValueSize];
+            std::memcpy(slotKey, slot.key, keyLength);
+            std::memcpy(value, slot.value, valueLength);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+
+            if (sequence == 0) {
+                m_misses.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            if (slotHash == hash && std::string_view(slotKey, keyLength) == key) {
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+                return std::string(value, valueLength);
+            }
+            break;
+        }
+    }
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+}
+
+bool SharedTable::put(std::string_view key, std::string_view value) {
+    if (key.size() > MaxKeySize || value.size() > MaxValueSize) {
+        m_skippedWrites.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Reuse the slot holding the key or the first empty one, otherwise evict a hash-chosen victim.
+    uint64_t hash = HashKey(key);
+    Slot* target = &m_slots[(hash + (hash >> 32) % Layout::ProbeCount) & m_mask];
+    for (size_t probe = 0; probe < Layout::ProbeCount; ++probe) {
+        Slot& slot = m_slots[(hash + probe) & m_mask];
+        uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == 0 || (slot.hash == hash && slot.keyLength == key.size() && std::memcmp(slot.key, key.data(), key.size()) == 0)) {
+            target = &slot;
+            break;
+        }
+    }
+
+    // Writers never wait on each other: a slot left odd by a crashed writer is just never written again.
+    uint32_t sequence = target->sequence.load(std::memory_order_relaxed);
+    for (size_t attempt = 0;; ++attempt) {
+        if (attempt == Layout::WriteAttempts) {
+            m_skippedWrites.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (sequence & 1) {
+            sequence = target->sequence.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (target->sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            break;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    target->hash = hash;
+    target->keyLength = static_cast<uint16_t>(key.size());
+    target->valueLength = static_cast<uint16_t>(value.size());
+    std::memcpy(target->key, key.data(), key.size());
+    std::memcpy(target->value, value.data(), value.size());
+    target->sequence.store(sequence + 2, std::memory_order_release);
+    m_writes.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+SharedTable::Stats SharedTable::stats() const {
+    return {
+        m_hits.load(std::memory_order_relaxed),
+        m_misses.load(std::memory_order_relaxed),
+        m_writes.load(std::memory_order_relaxed),
+        m_skippedWrites.load(std::memory_order_relaxed)
+    };
+}
+
+} // namespace ytcpp
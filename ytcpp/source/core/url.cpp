@@ -0,0 +1,143 @@
+#include "ytcpp/core/url.hpp"
+
+namespace ytcpp {
+
+static int HexValue(char character) {
+    if (character >= '0' && character <= '9')
+        return character - '0';
+    if (character >= 'a' && character <= 'f')
+        return character - 'a' + 10;
+    if (character >= 'A' && character <= 'F')
+        return character - 'A' + 10;
+    return -1;
+}
+
+static bool IsUnreserved(char character) {
+    return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') || (character >= '0' && character <= '9')
+        || character == '-' || character == '_' || character == '.' || character == '!' || character == '~'
+        || character == '*' || character == '\'' || character == '(' || character == ')';
+}
+
+static std::string_view QueryPart(std::string_view urlOrQuery, size_t* offset = nullptr) {
+    size_t begin = urlOrQuery.find('?');
+    if (begin != std::string_view::npos)
+        begin += 1;
+    else if (urlOrQuery.find("://") != std::string_view::npos)
+        begin = urlOrQuery.size();
+    else
+        begin = 0;
+
+    size_t end = urlOrQuery.find('#', begin);
+    if (end == std::string_view::npos)
+        end = urlOrQuery.size();
+
+    if (offset)
+        *offset = begin;
+    return urlOrQuery.substr(begin, end - begin);
+}
+
+std::string Url::Decode(std::string_view string) {
+    std::string result;
+    result.reserve(string.size());
+    for (size_t index = 0, size = string.size(); index < size; ++index) {
+        if (string[index] == '%' && index + 2 < size) {
+            int high = HexValue(string[index + 1]);
+            int low = HexValue(string[index + 2]);
+            if (high >= 0 && low >= 0) {
+                result += static_cast<char>(high * 16 + low);
+                index += 2;
+                continue;
+            }
+        }
+        result += string[index];
+    }
+    return result;
+}
+
+std::string Url::Encode(std::string_view string) {
+    constexpr const char* HexDigits = "0123456789ABCDEF";
+
+    std::string result;
+    result.reserve(string.size());
+    for (char character : string) {
+        if (IsUnreserved(character)) {
+            result += character;
+            continue;
+        }
+
+        unsigned char byte = static_cast<unsigned char>(character);
+        result += '%';
+        result += HexDigits[byte >> 4];
+        result += HexDigits[byte & 0x0F];
+    }
+    return result;
+}
+
+Url::Query::Query(std::string_view urlOrQuery) {
+    std::string_view query = QueryPart(urlOrQuery);
+    while (!query.empty()) {
+        size_t end = query.find('&');
+        std::string_view parameter = query.substr(0, end);
+        query = (end == std::string_view::npos) ? std::string_view() : query.substr(end + 1);
+        if (parameter.empty())
+            continue;
+
+        size_t separator = parameter.find('=');
+        if (separator == std::string_view::npos)
+            m_parameters.emplace_back(parameter, std::string_view());
+        else
+            m_parameters.emplace_back(parameter.substr(0, separator), parameter.substr(separator + 1));
+    }
+}
+
+std::optional<std::string_view> Url::Query::find(std::string_view name) const {
+    for (const Parameter& parameter : m_parameters) {
+        if (parameter.first == name)
+            return parameter.second;
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> Url::Query::get(std::string_view name) const {
+    std::optional<std::string_view> value = find(name);
+    if (!value)
+        return std::nullopt;
+    return Decode(*value);
+}
+
+std::string Url::SetParameter(std::string_view url, std::string_view name, std::string_view value) {
+    size_t offset = 0;
+    std::string_view query = QueryPart(url, &offset);
+    if (url.find('?') == std::string_view::npos && url.find("://") != std::string_view::npos)
+        return std::string(url) + '?' + std::string(name) + '=' + Encode(value);
+
+    for (size_t begin = 0; begin <= query.size();) {
+        size_t end = query.find('&', begin);
+        if (end == std::string_view::npos)
+            end = query.size();
+
+        std::string_view parameter = query.substr(begin, end - begin);
+        size_t separator = parameter.find('=');
+        if (parameter.substr(0, separator) == name) {
+            size_t valueBegin = offset + begin + (separator == std::string_view::npos ? parameter.size() : separator + 1);
+            std::string result(url.substr(0, valueBegin));
+            if (separator == std::string_view::npos)
+                result += '=';
+            result += Encode(value);
+            result += url.substr(offset + end);
+            return result;
+        }
+        begin = end + 1;
+    }
+
+    std::string result(url.substr(0, offset + query.size()));
+    if (!query.empty())
+        result += '&';
+    result += name;
+    result += '=';
+    result += Encode(value);
+    result += url.substr(offset + query.size());
+    return result;
+}
+
+} // namespace ytcpp
@@ -1,11 +1,18 @@
 #include "ytcpp/format.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <mutex>
-#include <map>
+#include <tuple>
 
 #include "ytcpp/core/error.hpp"
 #include "ytcpp/core/logger.hpp"
+#include "ytcpp/core/lru_cache.hpp"
+#include "ytcpp/core/stopwatch.hpp"
+#include "ytcpp/core/url.hpp"
 #include "ytcpp/innertube.hpp"
+#include "ytcpp/negative_cache.hpp"
 #include "ytcpp/player.hpp"
 #include "ytcpp/utility.hpp"
 
@@ -48,39 +55,170 @@ static std::string ExtractCodec(const std::string& mimeType) {
     return mimeType.substr(begin + 1, end - begin - 1);
 }
 
-static const Player& GetPlayer() {
-    static std::mutex mutex;
-    std::lock_guard lock(mutex);
+namespace ListCache {
+    using namespace std::chrono_literals;
 
-    static std::map<std::string, Player> cache;
-    std::string playerId = Player::GetPlayerId();
-    auto playerEntry = cache.find(playerId);
-    if (playerEntry == cache.end())
-        playerEntry = cache.emplace(playerId, playerId).first;
-    return playerEntry->second;
+    constexpr auto RefreshMargin = 30min;
+    constexpr auto ExpiryMargin = 5min;
+    constexpr uint64_t HotHits = 2;
 }
 
-Format::List::List(const std::string& videoIdOrUrl) {
-    const Player& player = GetPlayer();
-    Curl::Response response = Innertube::CallApi(
-        Client::Type::Tv, "player", {
+struct FormatListEntry {
+    Format::List::Shared list;
+    Format::List::Clock::time_point refreshAt;
+    Format::List::Clock::time_point staleAt;
+    std::atomic<uint64_t> hits = 0;
+    std::atomic<bool> refreshing = false;
+};
+
+static std::optional<Format::List::Clock::time_point> ExtractExpiry(const std::string& rawUrl) {
+    std::optional<std::string> expire;
+    if (rawUrl.find("://") != std::string::npos) {
+        expire = Url::Query(rawUrl).get("expire");
+    }
+    else if (std::optional<std::string> url = Url::Query(rawUrl).get("url")) {
+        expire = Url::Query(*url).get("expire");
+    }
+    if (!expire)
+        return std::nullopt;
+
+    int64_t seconds = 0;
+    auto [end, error] = std::from_chars(expire->data(), expire->data() + expire->size(), seconds);
+    if (error != std::errc() || end != expire->data() + expire->size())
+        return std::nullopt;
+    return Format::List::Clock::time_point(std::chrono::seconds(seconds));
+}
+
+static std::shared_ptr<FormatListEntry> MakeListEntry(const std::string& videoId, Context& context) {
+    auto entry = std::make_shared<FormatListEntry>();
+    entry->list = std::make_shared<const Format::List>(videoId, Format::List::Mode::Eager, context);
+    if (!entry->list->expiresAt())
+        return entry;
+
+    entry->staleAt = *entry->list->expiresAt() - ListCache::ExpiryMargin;
+    entry->refreshAt = *entry->list->expiresAt() - ListCache::RefreshMargin;
+    if (entry->staleAt > Format::List::Clock::now())
+        context.formatLists().put(videoId, entry);
+    return entry;
+}
+
+static void RefreshListEntry(const std::string& videoId, std::shared_ptr<FormatListEntry> entry, Context& context) {
+    context.executor()->post([videoId, entry, &context, work = Context::Work(context)] {
+        Context::Scope scope(context);
+        try {
+            MakeListEntry(videoId, context);
+            Logger::Debug("Video \"{}\": Refreshed cached format list", videoId);
+        }
+        catch (const std::exception& error) {
+            Logger::Warn("Video \"{}\": Couldn't refresh cached format list ({})", videoId, error.what());
+        }
+        entry->refreshing = false;
+    });
+}
+
+static json PlayerRequestData(const std::string& videoId, const Player& player) {
+    return {
         {"playbackContext", {
             {"contentPlaybackContext", {
                 {"signatureTimestamp", player.signatureTimestamp()}
             }}
         }},
-        {"videoId", Utility::ExtractVideoId(videoIdOrUrl)}
-    });
+        {"videoId", videoId}
+    };
+}
+
+static Curl::Response CheckPlayerResponse(Curl::Response&& response) {
     if (response.code != 200) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't get \"player\" response [client: Tv, response code: {}]",
             response.code
         ).withDump(response.data);
     }
+    return std::move(response);
+}
+
+static Curl::Response RequestPlayer(const std::string& videoId, const Player& player) {
+    return CheckPlayerResponse(Innertube::CallApi(Client::Type::Tv, "player", PlayerRequestData(videoId, player)));
+}
+
+std::future<Format::List> Format::List::Async(const std::string& videoIdOrUrl, Mode mode, Context& context) {
+    return context.async(
+        [videoIdOrUrl, &context]() {
+            std::string videoId = Utility::ExtractVideoId(videoIdOrUrl);
+            NegativeCache::Check(videoId);
+            std::shared_ptr<const Player> player = context.player(Player::GetPlayerId());
+            Curl::Response response = RequestPlayer(videoId, *player);
+            return std::tuple(std::move(videoId), std::move(player), std::move(response));
+        },
+        [mode](std::tuple<std::string, std::shared_ptr<const Player>, Curl::Response>&& fetched) {
+            auto& [videoId, player, response] = fetched;
+            List list;
+            list.parse(videoId, response, player, mode);
+            return list;
+        }
+    );
+}
+
+// Player code is still downloaded and compiled in place the first time a player ID is seen.
+Task<Format::List> Format::List::Fetch(std::string videoIdOrUrl, Mode mode, std::stop_token stopToken, Context& context) {
+    std::string videoId;
+    {
+        Context::Scope scope(context);
+        videoId = Utility::ExtractVideoId(videoIdOrUrl);
+        NegativeCache::Check(videoId);
+    }
+
+    // Players are built with blocking requests, so the build runs on the I/O pool while this coroutine is suspended.
+    std::string playerId = co_await Player::GetPlayerIdAsync(stopToken, context);
+    std::shared_ptr<const Player> player = co_await context.offload([&context, playerId]() {
+        return context.player(playerId);
+    });
+    Task<Curl::Response> request = Innertube::CallApiAsync(Client::Type::Tv, "player", PlayerRequestData(videoId, *player), stopToken, context);
+    Curl::Response response = CheckPlayerResponse(co_await std::move(request));
+
+    Context::Scope scope(context);
+    List list;
+    list.parse(videoId, response, player, mode);
+    co_return list;
+}
+
+Format::List::Shared Format::List::Cached(const std::string& videoIdOrUrl, Context& context) {
+    std::string videoId = Utility::ExtractVideoId(videoIdOrUrl);
+    std::optional<std::shared_ptr<FormatListEntry>> entry = context.formatLists().get(videoId);
+    Clock::time_point now = Clock::now();
+    if (!entry || now >= (*entry)->staleAt)
+        return MakeListEntry(videoId, context)->list;
+
+    // Hot lists are rebuilt in the background before their URLs expire.
+    uint64_t hits = ++(*entry)->hits;
+    if (now >= (*entry)->refreshAt && hits >= ListCache::HotHits && !(*entry)->refreshing.exchange(true))
+        RefreshListEntry(videoId, *entry, context);
+    return (*entry)->list;
+}
+
+void Format::List::ClearCache(Context& context) {
+    context.formatLists().clear();
+}
+
+Format::List Format::List::Parse(const std::string& videoId, const std::string& response, const std::shared_ptr<const Player>& player, Mode mode) {
+    List list;
+    list.parse(videoId, { 200, {}, response }, player, mode);
+    return list;
+}
 
+Format::List::List(const std::string& videoIdOrUrl, Mode mode, Context& context) {
+    Context::Scope scope(context);
+    std::string videoId = Utility::ExtractVideoId(videoIdOrUrl);
+    NegativeCache::Check(videoId);
+
+    std::shared_ptr<const Player> player = context.player(Player::GetPlayerId());
+    parse(videoId, RequestPlayer(videoId, *player), player, mode);
+}
+
+void Format::List::parse(const std::string& videoId, const Curl::Response& response, const std::shared_ptr<const Player>& player, Mode mode) {
     try {
         const json responseJson = json::parse(response.data);
-        Utility::CheckPlayability(responseJson.at("playabilityStatus"));
+        NegativeCache::CheckPlayability(videoId, responseJson.at("playabilityStatus"));
         if (!responseJson.contains("streamingData"))
             return;
 
@@ -88,14 +226,16 @@ Format::List::List(const std::string& videoIdOrUrl) {
         reserve(formats.size());
         for (const json& format : formats) {
             Type type = ExtractType(format.at("mimeType"));
-            if (type == Format::Type::Video) {
-                std::string& url = emplace_back(std::make_unique<VideoFormat>(format))->m_url;
-                url = player.prepareUrl(url);
-            }
-            else if (type == Format::Type::Audio) {
-                std::string& url = emplace_back(std::make_unique<AudioFormat>(format))->m_url;
-                url = player.prepareUrl(url);
-            }
+            if (type == Format::Type::Video)
+                emplace_back(std::make_unique<VideoFormat>(format));
+            else if (type == Format::Type::Audio)
+                emplace_back(std::make_unique<AudioFormat>(format));
+            else
+                continue;
+
+            std::optional<Clock::time_point> expiresAt = ExtractExpiry(back()->m_url);
+            if (expiresAt && (!m_expiresAt || *expiresAt < *m_expiresAt))
+                m_expiresAt = expiresAt;
         }
     }
     catch (const json::exception& error) {
@@ -104,6 +244,30 @@ Format::List::List(const std::string& videoIdOrUrl) {
             error.id
         ).withDump(response.data);
     }
+
+    if (mode == Mode::Lazy) {
+        for (const Instance& format : *this)
+            format->m_player = player;
+        Logger::Debug("Deferred deciphering of {} format URLs", size());
+        return;
+    }
+
+    Stopwatch stopwatch;
+    uint64_t evaluations = Js::Interpreter::Evaluations();
+    std::vector<std::string> urls;
+    urls.reserve(size());
+    for (const Instance& format : *this)
+        urls.push_back(format->m_url);
+
+    urls = player->prepareUrls(urls);
+    for (size_t index = 0, count = size(); index < count; ++index)
+        at(index)->m_url = std::move(urls[index]);
+    stopwatch.stop();
+
+    Logger::Debug(
+        "Deciphered {} format URLs ({} ms, {} JS evaluations)",
+        size(), stopwatch.ms(), Js::Interpreter::Evaluations() - evaluations
+    );
 }
 
 Format::Format(const json& object)
@@ -119,6 +283,15 @@ Format::Format(const json& object)
         m_duration.emplace(0, 0, 0, Utility::ExtractNumber(object.at("approxDurationMs")) * 1000);
 }
 
+const std::string& Format::url() const {
+    if (m_player) {
+        std::call_once(m_urlPrepared, [this]() {
+            m_url = m_player->prepareUrl(m_url);
+        });
+    }
+    return m_url;
+}
+
 VideoFormat::VideoFormat(const json& object)
     : Format(object)
     , m_dimensions(object)
@@ -1,9 +1,14 @@
 #include "ytcpp/innertube.hpp"
 
 #include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <optional>
+#include <tuple>
 #include <thread>
 #include <chrono>
 using namespace std::chrono_literals;
+namespace fs = std::filesystem;
 
 #include <boost/date_time.hpp>
 namespace dt = boost::gregorian;
@@ -19,8 +24,10 @@ namespace uuid = boost::uuids;
 using nlohmann::json;
 
 #include "ytcpp/core/error.hpp"
+#include "ytcpp/core/io.hpp"
 #include "ytcpp/core/logger.hpp"
 #include "ytcpp/core/stopwatch.hpp"
+#include "ytcpp/metrics.hpp"
 
 namespace ytcpp {
 
@@ -30,6 +37,28 @@ namespace Urls {
     constexpr const char* ApiRequest = "https://www.youtube.com/youtubei/v1/{}?prettyPrint=false";
 }
 
+namespace Keys {
+    constexpr const char* Auth = "auth";
+}
+
+namespace Names {
+    constexpr const char* ApiRequests = "ytcpp_innertube_requests_total";
+    constexpr const char* ApiRequestDuration = "ytcpp_innertube_request_duration_seconds";
+    constexpr const char* AuthUpdates = "ytcpp_auth_updates_total";
+}
+
+constexpr const char* LegacyCacheFile = ".ytcpp_cache.json";
+namespace Objects {
+    namespace Auth {
+        constexpr const char* Object = "auth";
+        constexpr const char* Authorized = "authorized";
+        constexpr const char* AccessToken = "access_token";
+        constexpr const char* AccessTokenType = "access_token_type";
+        constexpr const char* ExpiresAt = "expires_at";
+        constexpr const char* RefreshToken = "refresh_token";
+    }
+}
+
 static inline std::string GenerateUuid(bool includeDashes = true) {
     std::string result = uuid::to_string(uuid::random_generator_mt19937()());
     if (!includeDashes)
@@ -43,7 +72,82 @@ static inline int GetUnixTimestamp() {
     return static_cast<int>((now - epoch).total_seconds());
 }
 
-static void Authorize(Cache& cache) {
+static const char* ClientName(Client::Type client) {
+    switch (client) {
+        case Client::Type::AndroidTestsuite:
+            return "AndroidTestsuite";
+        case Client::Type::Tv:
+            return "Tv";
+        case Client::Type::TvEmbed:
+            return "TvEmbed";
+        default:
+            return "Auth";
+    }
+}
+
+struct ApiMetrics {
+    Metrics::Counter* requests = nullptr;
+    Metrics::Histogram* duration = nullptr;
+};
+
+static void RecordCall(Client::Type client, const std::string& endpoint, std::string_view status, uint64_t us) {
+    thread_local Metrics::HandleCache<ApiMetrics> cache;
+    const ApiMetrics& metrics = cache.get({ ClientName(client), endpoint, status }, [&]() {
+        ApiMetrics metrics;
+        metrics.requests = &Metrics::GetCounter(Names::ApiRequests, { {"endpoint", endpoint}, {"client", ClientName(client)}, {"status", std::string(status)} });
+        metrics.duration = &Metrics::GetHistogram(Names::ApiRequestDuration, { {"endpoint", endpoint}, {"client", ClientName(client)} });
+        return metrics;
+    });
+    metrics.requests->add();
+    metrics.duration->observe(us);
+}
+
+static void RecordCall(Client::Type client, const std::string& endpoint, long code, uint64_t us) {
+    char status[24];
+    char* statusEnd = std::to_chars(status, status + sizeof(status), code).ptr;
+    RecordCall(client, endpoint, std::string_view(status, statusEnd - status), us);
+}
+
+static Innertube::Auth ParseAuth(const json& authObject) {
+    Innertube::Auth auth;
+    auth.authorized = authObject.at(Objects::Auth::Authorized);
+    auth.accessToken = authObject.at(Objects::Auth::AccessToken);
+    auth.accessTokenType = authObject.at(Objects::Auth::AccessTokenType);
+    auth.expiresAt = authObject.at(Objects::Auth::ExpiresAt);
+    auth.refreshToken = authObject.at(Objects::Auth::RefreshToken);
+    return auth;
+}
+
+static std::string SerializeAuth(const Innertube::Auth& auth) {
+    json authObject;
+    authObject[Objects::Auth::Authorized] = auth.authorized;
+    authObject[Objects::Auth::AccessToken] = auth.accessToken;
+    authObject[Objects::Auth::AccessTokenType] = auth.accessTokenType;
+    authObject[Objects::Auth::ExpiresAt] = auth.expiresAt;
+    authObject[Objects::Auth::RefreshToken] = auth.refreshToken;
+    return authObject.dump(4) + '\n';
+}
+
+static Innertube::Auth LoadAuth(const Cache::Value& value) {
+    try {
+        if (value)
+            return ParseAuth(json::parse(*value));
+
+        // Auth saved by older versions is picked up once and moved into the cache store.
+        if (fs::is_regular_file(LegacyCacheFile))
+            return ParseAuth(json::parse(IO::ReadFile(LegacyCacheFile)).at(Objects::Auth::Object));
+        return {};
+    }
+    catch (const json::exception& error) {
+        throw YTCPP_LOCATED_ERROR("Couldn't parse cached auth JSON [error id: {}]", error.id);
+    }
+}
+
+static inline bool IsFresh(const Innertube::Auth& auth) {
+    return auth.authorized && GetUnixTimestamp() + 10 < auth.expiresAt;
+}
+
+static void Authorize(Innertube::Auth& auth) {
     Client::Fields fields = Client::ClientFields(Client::Type::AuthCode, { {"device_id", GenerateUuid(false)} });
     Curl::Response response = Curl::Post(Urls::AuthCode, fields.headers, fields.data.dump());
     if (response.code != 200) {
@@ -95,7 +199,6 @@ static void Authorize(Cache& cache) {
                 ).withDump(response.data);
             }
 
-            Cache::Auth& auth = cache.auth();
             auth.authorized = true;
             auth.accessToken = responseJson.at("access_token");
             auth.accessTokenType = responseJson.at("token_type");
@@ -117,15 +220,9 @@ static void Authorize(Cache& cache) {
     throw YTCPP_LOCATED_ERROR("Couldn't authorize in {} seconds", expiresIn);
 }
 
-Cache::Auth Innertube::UpdateAuth() {
-    Cache cache;
-    if (!cache.auth().authorized)
-        Authorize(cache);
-    if (GetUnixTimestamp() + 10 < cache.auth().expiresAt)
-        return cache.auth();
-
+static void RefreshAuth(Innertube::Auth& auth) {
     Stopwatch stopwatch;
-    Client::Fields fields = Client::ClientFields(Client::Type::AuthTokenRefresh, { {"refresh_token", cache.auth().refreshToken} });
+    Client::Fields fields = Client::ClientFields(Client::Type::AuthTokenRefresh, { {"refresh_token", auth.refreshToken} });
     Curl::Response response = Curl::Post(Urls::AuthToken, fields.headers, fields.data.dump());
     if (response.code != 200) {
         throw YTCPP_LOCATED_ERROR(
@@ -143,14 +240,12 @@ Cache::Auth Innertube::UpdateAuth() {
             ).withDump(response.data);
         }
 
-        Cache::Auth& auth = cache.auth();
         auth.accessToken = responseJson.at("access_token");
         auth.accessTokenType = responseJson.at("token_type");
         auth.expiresAt = GetUnixTimestamp() + responseJson.at("expires_in").get<int>();
         stopwatch.stop();
 
         Logger::Debug("Access token \"{}\" refreshed ({} ms), expires at {}", auth.accessTokenType, stopwatch.ms(), auth.expiresAt);
-        return auth;
     }
     catch (const json::exception& error) {
         throw YTCPP_LOCATED_ERROR(
@@ -160,16 +255,150 @@ Cache::Auth Innertube::UpdateAuth() {
     }
 }
 
-Curl::Response Innertube::CallApi(Client::Type client, const std::string& endpoint, const json& additionalData) {
+Innertube::Auth Innertube::UpdateAuth() {
+    Cache::Value value = Cache::Read(Keys::Auth);
+    if (value) {
+        Auth auth = LoadAuth(value);
+        if (IsFresh(auth))
+            return auth;
+    }
+
+    // Only one thread refreshes, others reuse its result once the lock is released.
+    std::lock_guard lock(Instance().m_authMutex);
+    Auth auth;
+    Cache::Update(Keys::Auth, [&auth](const Cache::Value& current) -> std::optional<std::string> {
+        auth = LoadAuth(current);
+        if (current && IsFresh(auth))
+            return std::nullopt;
+
+        if (!auth.authorized) {
+            Authorize(auth);
+            Metrics::GetCounter(Names::AuthUpdates, { {"type", "authorization"} }).add();
+        }
+        if (!IsFresh(auth)) {
+            RefreshAuth(auth);
+            Metrics::GetCounter(Names::AuthUpdates, { {"type", "refresh"} }).add();
+        }
+        return SerializeAuth(auth);
+    });
+    return auth;
+}
+
+void Innertube::UpdateSettings(const std::function<void(Settings& settings)>& update) {
+    // Writers are serialized so concurrent updates don't lose each other's changes.
+    std::lock_guard lock(Instance().m_mutex);
+    Settings settings = *CurrentSettings();
+    update(settings);
+    Instance().m_settings.store(std::make_shared<const Settings>(std::move(settings)), std::memory_order_release);
+}
+
+std::pair<std::shared_ptr<Innertube::ResponseCache>, std::chrono::seconds> Innertube::ResponseCacheFor(const Settings& settings, const std::string& endpoint) {
+    if (!settings.responseCache)
+        return {};
+
+    auto ttl = settings.responseTtls.find(endpoint);
+    if (ttl == settings.responseTtls.end() || ttl->second <= 0s)
+        return {};
+    return { settings.responseCache, ttl->second };
+}
+
+Innertube::PreparedCall Innertube::PrepareCall(Client::Type client, const std::string& endpoint, const json& additionalData) {
     Client::Fields fields = Client::ClientFields(client, additionalData);
-    if (AuthEnabled()) {
-        Cache::Auth auth = UpdateAuth();
+    std::shared_ptr<const Settings> settings = CurrentSettings();
+    bool authEnabled = settings->authEnabled;
+    if (authEnabled) {
+        Auth auth = UpdateAuth();
         fields.headers.push_back(fmt::format(
             "Authorization: {} {}",
             auth.accessTokenType, auth.accessToken
         ));
     }
-    return Curl::Post(fmt::format(Urls::ApiRequest, endpoint), fields.headers, fields.data.dump());
+
+    PreparedCall call;
+    call.url = fmt::format(Urls::ApiRequest, endpoint);
+    call.headers = std::move(fields.headers);
+    call.data = fields.data.dump();
+    std::tie(call.responseCache, call.ttl) = ResponseCacheFor(*settings, endpoint);
+    if (call.responseCache)
+        call.key = fmt::format("{}:{}:{}:{}", static_cast<int>(client), endpoint, authEnabled, call.data);
+    return call;
+}
+
+std::optional<Curl::Response> Innertube::CachedResponse(const PreparedCall& call) {
+    if (!call.responseCache)
+        return std::nullopt;
+    return call.responseCache->get(call.key);
+}
+
+void Innertube::StoreResponse(const PreparedCall& call, const Curl::Response& response) {
+    if (!call.responseCache || response.code != 200)
+        return;
+    size_t cost = call.key.size() + response.headers.size() + response.data.size();
+    call.responseCache->put(call.key, response, cost, call.ttl);
+}
+
+Curl::Response Innertube::CallApi(Client::Type client, const std::string& endpoint, const json& additionalData) {
+    Stopwatch stopwatch;
+    PreparedCall call = PrepareCall(client, endpoint, additionalData);
+    if (std::optional<Curl::Response> response = CachedResponse(call)) {
+        RecordCall(client, endpoint, "cached", stopwatch.us());
+        return *response;
+    }
+
+    Curl::Response response = Curl::Post(call.url, call.headers, call.data);
+    RecordCall(client, endpoint, response.code, stopwatch.us());
+    StoreResponse(call, response);
+    return response;
+}
+
+// Arguments are taken by value, they have to outlive the caller's full expression.
+Task<Curl::Response> Innertube::CallApiAsync(Client::Type client, std::string endpoint, json additionalData, std::stop_token stopToken, Context& context) {
+    Stopwatch stopwatch;
+    std::optional<Curl::Operation> operation;
+    PreparedCall call;
+    {
+        Context::Scope scope(context);
+        call = PrepareCall(client, endpoint, additionalData);
+        if (std::optional<Curl::Response> response = CachedResponse(call)) {
+            RecordCall(client, endpoint, "cached", stopwatch.us());
+            co_return std::move(*response);
+        }
+        operation.emplace(Curl::AsyncPost(call.url, call.headers, call.data, std::move(stopToken)));
+    }
+
+    Curl::Response response = co_await std::move(*operation);
+    Context::Scope scope(context);
+    RecordCall(client, endpoint, response.code, stopwatch.us());
+    StoreResponse(call, response);
+    co_return response;
+}
+
+Innertube::ResponseTtls Innertube::DefaultResponseTtls() {
+    return {
+        {"player", 5min},
+        {"browse", 10min},
+        {"search", 10min},
+        {"next", 10min},
+    };
+}
+
+void Innertube::EnableResponseCache(size_t maxBytes, const ResponseTtls& ttls) {
+    std::shared_ptr<ResponseCache> responseCache = std::make_shared<ResponseCache>(maxBytes);
+    UpdateSettings([&](Settings& settings) {
+        settings.responseCache = std::move(responseCache);
+        settings.responseTtls = ttls;
+    });
+}
+
+void Innertube::DisableResponseCache() {
+    UpdateSettings([](Settings& settings) {
+        settings.responseCache.reset();
+    });
+}
+
+Innertube::ResponseCache::Stats Innertube::ResponseCacheStats() {
+    std::shared_ptr<const Settings> settings = CurrentSettings();
+    return settings->responseCache ? settings->responseCache->stats() : ResponseCache::Stats();
 }
 
 } // namespace ytcpp
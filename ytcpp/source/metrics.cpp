@@ -0,0 +1,208 @@
+#include "ytcpp/metrics.hpp"
+
+#include <mutex>
+
+#include <fmt/format.h>
+
+#include "ytcpp/core/js.hpp"
+#include "ytcpp/context.hpp"
+#include "ytcpp/innertube.hpp"
+#include "ytcpp/negative_cache.hpp"
+#include "ytcpp/player.hpp"
+
+namespace ytcpp {
+
+namespace Names {
+    constexpr const char* JsEvaluations = "ytcpp_js_evaluations_total";
+    constexpr const char* CacheHits = "ytcpp_cache_hits_total";
+    constexpr const char* CacheMisses = "ytcpp_cache_misses_total";
+    constexpr const char* CacheEvictions = "ytcpp_cache_evictions_total";
+    constexpr const char* CacheEntries = "ytcpp_cache_entries";
+}
+
+template <typename Metric>
+static Metric& GetMetric(std::shared_mutex& mutex, std::map<std::pair<std::string, Metrics::Labels>, std::unique_ptr<Metric>>& metrics, const std::string& name, const Metrics::Labels& labels) {
+    std::pair<std::string, Metrics::Labels> key(name, labels);
+    {
+        std::shared_lock lock(mutex);
+        auto metric = metrics.find(key);
+        if (metric != metrics.end())
+            return *metric->second;
+    }
+
+    std::lock_guard lock(mutex);
+    std::unique_ptr<Metric>& metric = metrics[std::move(key)];
+    if (!metric)
+        metric = std::make_unique<Metric>();
+    return *metric;
+}
+
+static Metrics::Sample MakeSample(const char* name, const char* cache, Metrics::Sample::Type type, uint64_t value) {
+    Metrics::Sample sample;
+    sample.name = name;
+    sample.labels = { {"cache", cache} };
+    sample.type = type;
+    sample.value = value;
+    return sample;
+}
+
+template <typename Stats>
+static void AddCacheSamples(Metrics::Snapshot& snapshot, const char* cache, const Stats& stats) {
+    snapshot.push_back(MakeSample(Names::CacheHits, cache, Metrics::Sample::Type::Counter, stats.hits));
+    snapshot.push_back(MakeSample(Names::CacheMisses, cache, Metrics::Sample::Type::Counter, stats.misses));
+    snapshot.push_back(MakeSample(Names::CacheEvictions, cache, Metrics::Sample::Type::Counter, stats.evictions));
+    snapshot.push_back(MakeSample(Names::CacheEntries, cache, Metrics::Sample::Type::Gauge, stats.size));
+}
+
+static std::string EscapeLabelValue(const std::string& value) {
+    std::string result;
+    result.reserve(value.size());
+    for (char character : value) {
+        if (character == '\\' || character == '"')
+            result += '\\';
+        if (character == '\n') {
+            result += "\\n";
+            continue;
+        }
+        result += character;
+    }
+    return result;
+}
+
+static std::string FormatLabels(const Metrics::Labels& labels, const std::string& extra = {}) {
+    if (labels.empty() && extra.empty())
+        return {};
+
+    std::string result = "{";
+    for (const auto& [name, value] : labels) {
+        if (result.size() > 1)
+            result += ',';
+        result += fmt::format("{}=\"{}\"", name, EscapeLabelValue(value));
+    }
+    if (!extra.empty()) {
+        if (result.size() > 1)
+            result += ',';
+        result += extra;
+    }
+    return result + '}';
+}
+
+static const char* TypeName(Metrics::Sample::Type type) {
+    switch (type) {
+        case Metrics::Sample::Type::Counter:
+            return "counter";
+        case Metrics::Sample::Type::Gauge:
+            return "gauge";
+        case Metrics::Sample::Type::Histogram:
+            return "histogram";
+        default:
+            return "untyped";
+    }
+}
+
+double Metrics::Sample::quantile(double quantile) const {
+    if (!value || buckets.empty())
+        return 0.0;
+
+    uint64_t rank = static_cast<uint64_t>(std::clamp(quantile, 0.0, 1.0) * value), seen = 0;
+    for (size_t index = 0; index + 1 < buckets.size(); ++index) {
+        seen += buckets[index];
+        if (seen > rank || seen == value)
+            return Histogram::BucketBound(index) / 1e6;
+    }
+    return Histogram::BucketBound(buckets.size() - 1) / 1e6;
+}
+
+Metrics::Metrics() {
+    static std::atomic<uint64_t> registryCount = 0;
+    m_id = ++registryCount;
+}
+
+uint64_t Metrics::RegistryId() {
+    return Instance().m_id;
+}
+
+Metrics::Counter& Metrics::GetCounter(const std::string& name, const Labels& labels) {
+    return GetMetric(Instance().m_mutex, Instance().m_counters, name, labels);
+}
+
+Metrics::Histogram& Metrics::GetHistogram(const std::string& name, const Labels& labels) {
+    return GetMetric(Instance().m_mutex, Instance().m_histograms, name, labels);
+}
+
+Metrics::Snapshot Metrics::Collect() {
+    Snapshot snapshot;
+    {
+        std::shared_lock lock(Instance().m_mutex);
+        snapshot.reserve(Instance().m_counters.size() + Instance().m_histograms.size());
+        for (const auto& [key, counter] : Instance().m_counters) {
+            Sample& sample = snapshot.emplace_back();
+            sample.name = key.first;
+            sample.labels = key.second;
+            sample.type = Sample::Type::Counter;
+            sample.value = counter->value();
+        }
+
+        for (const auto& [key, histogram] : Instance().m_histograms) {
+            Sample& sample = snapshot.emplace_back();
+            sample.name = key.first;
+            sample.labels = key.second;
+            sample.type = Sample::Type::Histogram;
+            sample.buckets = histogram->buckets();
+            sample.sum = histogram->sum();
+            for (uint64_t count : sample.buckets)
+                sample.value += count;
+        }
+    }
+
+    Sample& evaluations = snapshot.emplace_back();
+    evaluations.name = Names::JsEvaluations;
+    evaluations.value = Js::Interpreter::Evaluations();
+
+    AddCacheSamples(snapshot, "format_list", Context::Current().formatLists().stats());
+    AddCacheSamples(snapshot, "innertube_response", Innertube::ResponseCacheStats());
+    AddCacheSamples(snapshot, "negative", NegativeCache::GetStats());
+    AddCacheSamples(snapshot, "nsig", Player::NsigCacheStats());
+    if (std::optional<SharedTable::Stats> stats = Player::SharedCacheStats()) {
+        snapshot.push_back(MakeSample(Names::CacheHits, "shared_decipher", Sample::Type::Counter, stats->hits));
+        snapshot.push_back(MakeSample(Names::CacheMisses, "shared_decipher", Sample::Type::Counter, stats->misses));
+    }
+
+    std::stable_sort(snapshot.begin(), snapshot.end(), [](const Sample& left, const Sample& right) {
+        return left.name < right.name;
+    });
+    return snapshot;
+}
+
+void Metrics::Export(const Exporter& exporter) {
+    for (const Sample& sample : Collect())
+        exporter(sample);
+}
+
+std::string Metrics::Prometheus() {
+    std::string result;
+    const std::string* previousName = nullptr;
+    Snapshot snapshot = Collect();
+    for (const Sample& sample : snapshot) {
+        if (!previousName || *previousName != sample.name)
+            result += fmt::format("# TYPE {} {}\n", sample.name, TypeName(sample.type));
+        previousName = &sample.name;
+
+        if (sample.type != Sample::Type::Histogram) {
+            result += fmt::format("{}{} {}\n", sample.name, FormatLabels(sample.labels), sample.value);
+            continue;
+        }
+
+        uint64_t cumulative = 0;
+        for (size_t index = 0; index < sample.buckets.size(); ++index) {
+            cumulative += sample.buckets[index];
+            std::string bound = index + 1 < sample.buckets.size() ? fmt::format("{}", Histogram::BucketBound(index) / 1e6) : "+Inf";
+            result += fmt::format("{}_bucket{} {}\n", sample.name, FormatLabels(sample.labels, fmt::format("le=\"{}\"", bound)), cumulative);
+        }
+        result += fmt::format("{}_sum{} {}\n", sample.name, FormatLabels(sample.labels), sample.sum / 1e6);
+        result += fmt::format("{}_count{} {}\n", sample.name, FormatLabels(sample.labels), sample.value);
+    }
+    return result;
+}
+
+} // namespace ytcpp
@@ -0,0 +1,81 @@
+#include "ytcpp/negative_cache.hpp"
+
+#include "ytcpp/core/logger.hpp"
+#include "ytcpp/utility.hpp"
+
+namespace ytcpp {
+
+using namespace std::chrono_literals;
+
+constexpr size_t NegativeCacheCapacity = 65536;
+
+NegativeCache::NegativeCache()
+    : m_ttls(DefaultTtls())
+    , m_errors(NegativeCacheCapacity)
+{}
+
+NegativeCache::Ttls NegativeCache::DefaultTtls() {
+    return {
+        {YtError::Type::Private, 1h},
+        {YtError::Type::Unplayable, 1h},
+        {YtError::Type::Unavailable, 6h},
+        {YtError::Type::LoginRequired, 10min},
+    };
+}
+
+void NegativeCache::Check(const std::string& videoId) {
+    if (std::optional<YtError> error = Instance().m_errors.get(videoId))
+        throw *error;
+}
+
+void NegativeCache::CheckPlayability(const std::string& videoId, const json& object) {
+    try {
+        Utility::CheckPlayability(object);
+    }
+    catch (const YtError& error) {
+        Store(videoId, error);
+        throw;
+    }
+}
+
+void NegativeCache::Store(const std::string& videoId, const YtError& error) {
+    std::chrono::seconds ttl = 0s;
+    {
+        std::lock_guard lock(Instance().m_mutex);
+        auto entry = Instance().m_ttls.find(error.type());
+        if (entry != Instance().m_ttls.end())
+            ttl = entry->second;
+    }
+    if (ttl <= 0s)
+        return;
+
+    Instance().m_errors.put(videoId, error, 1, ttl);
+    Logger::Debug("Video \"{}\": Remembered \"{}\" error for {} s", videoId, YtError::TypeToString(error.type()), ttl.count());
+}
+
+void NegativeCache::Invalidate(const std::string& videoId) {
+    Instance().m_errors.erase(videoId);
+}
+
+void NegativeCache::Invalidate(YtError::Type type) {
+    size_t erased = Instance().m_errors.eraseIf([type](const std::string&, const YtError& error) {
+        return error.type() == type;
+    });
+    if (erased)
+        Logger::Debug("Forgot {} remembered \"{}\" errors", erased, YtError::TypeToString(type));
+}
+
+void NegativeCache::Clear() {
+    Instance().m_errors.clear();
+}
+
+void NegativeCache::SetTtl(YtError::Type type, std::chrono::seconds ttl) {
+    std::lock_guard lock(Instance().m_mutex);
+    Instance().m_ttls[type] = ttl;
+}
+
+NegativeCache::Stats NegativeCache::GetStats() {
+    return Instance().m_errors.stats();
+}
+
+} // namespace ytcpp
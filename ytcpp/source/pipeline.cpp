@@ -0,0 +1,122 @@
+#include "ytcpp/pipeline.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "ytcpp/core/logger.hpp"
+
+namespace ytcpp {
+
+Pipeline::Pipeline(Options options, Context& context)
+    : m_context(context)
+    , m_options(std::move(options))
+    , m_resolveQueue(m_options.queueCapacity)
+    , m_decipherQueue(m_options.queueCapacity)
+    , m_sinkQueue(m_options.queueCapacity) {
+    size_t resolveWorkers = std::max<size_t>(m_options.resolveWorkers, 1);
+    size_t decipherWorkers = std::max<size_t>(m_options.decipherWorkers, 1);
+    size_t sinkWorkers = m_options.sink ? std::max<size_t>(m_options.sinkWorkers, 1) : 0;
+    m_resolveWorkers = resolveWorkers;
+    m_decipherWorkers = decipherWorkers;
+    m_sinkWorkers = sinkWorkers;
+
+    BoundedQueue<Item>* decipherOutput = sinkWorkers ? &m_sinkQueue : nullptr;
+    m_threads.reserve(resolveWorkers + decipherWorkers + sinkWorkers);
+    for (size_t index = 0; index < resolveWorkers; ++index)
+        m_threads.emplace_back(&Pipeline::run, this, std::ref(m_resolveQueue), &m_decipherQueue, std::ref(m_resolveWorkers), &Pipeline::resolve);
+    for (size_t index = 0; index < decipherWorkers; ++index)
+        m_threads.emplace_back(&Pipeline::run, this, std::ref(m_decipherQueue), decipherOutput, std::ref(m_decipherWorkers), &Pipeline::decipher);
+    for (size_t index = 0; index < sinkWorkers; ++index)
+        m_threads.emplace_back(&Pipeline::run, this, std::ref(m_sinkQueue), nullptr, std::ref(m_sinkWorkers), &Pipeline::sink);
+}
+
+Pipeline::~Pipeline() {
+    wait();
+}
+
+void Pipeline::run(BoundedQueue<Item>& input, BoundedQueue<Item>* output, std::atomic<size_t>& workers, Stage stage) {
+    Context::Scope scope(m_context);
+    while (std::optional<Item> item = input.pop()) {
+        try {
+            (this->*stage)(*item);
+        }
+        catch (...) {
+            item->error = std::current_exception();
+        }
+
+        // Failed items skip the remaining stages.
+        if (item->error || !output)
+            complete(std::move(*item));
+        else
+            output->push(std::move(*item));
+    }
+
+    // The last worker of a stage lets the next one drain and stop.
+    if (--workers == 0 && output)
+        output->close();
+}
+
+void Pipeline::resolve(Item& item) {
+    if (m_options.resolveVideo)
+        item.video.emplace(item.input, m_context);
+    item.formats.emplace(item.video ? item.video->id() : item.input, Format::List::Mode::Lazy, m_context);
+}
+
+void Pipeline::decipher(Item& item) {
+    if (m_options.selector) {
+        item.selected = m_options.selector(item);
+    }
+    else {
+        item.selected.reserve(item.formats->size());
+        for (const Format::Instance& format : *item.formats)
+            item.selected.push_back(format.get());
+    }
+
+    for (const Format* format : item.selected)
+        format->url();
+}
+
+void Pipeline::sink(Item& item) {
+    m_options.sink(item);
+}
+
+void Pipeline::complete(Item&& item) {
+    if (item.error)
+        ++m_failed;
+    ++m_completed;
+    if (!m_options.completion)
+        return;
+
+    std::lock_guard lock(m_completionMutex);
+    try {
+        m_options.completion(std::move(item));
+    }
+    catch (const std::exception& error) {
+        Logger::Warn("Pipeline item {} completion failed ({})", item.index, error.what());
+    }
+}
+
+bool Pipeline::push(const std::string& videoIdOrUrl) {
+    Item item;
+    item.index = m_submitted++;
+    item.input = videoIdOrUrl;
+    if (!m_resolveQueue.push(std::move(item))) {
+        --m_submitted;
+        return false;
+    }
+    return true;
+}
+
+void Pipeline::close() {
+    m_resolveQueue.close();
+}
+
+void Pipeline::wait() {
+    close();
+    for (std::thread& thread : m_threads) {
+        if (thread.joinable())
+            thread.join();
+    }
+}
+
+} // namespace ytcpp
@@ -1,11 +1,24 @@
 #include "ytcpp/player.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string_view>
+
 #include <boost/regex.hpp>
 
+#include <nlohmann/json.hpp>
+using nlohmann::json;
+
+#include "ytcpp/core/cache.hpp"
 #include "ytcpp/core/curl.hpp"
 #include "ytcpp/core/error.hpp"
+#include "ytcpp/core/hash.hpp"
 #include "ytcpp/core/logger.hpp"
 #include "ytcpp/core/stopwatch.hpp"
+#include "ytcpp/core/url.hpp"
+#include "ytcpp/context.hpp"
+#include "ytcpp/metrics.hpp"
 
 namespace ytcpp {
 
@@ -14,29 +27,170 @@ namespace Urls {
     constexpr const char* PlayerCode = "https://www.youtube.com/s/player/{}/player_ias.vflset/en_US/base.js";
 }
 
+namespace Keys {
+    constexpr const char* PlayerArtifact = "player_{}.cbor";
+    constexpr const char* Signature = "{}:s:{}";
+    constexpr const char* Nsignature = "{}:n:{}";
+}
+
+namespace Names {
+    constexpr const char* PlayerBuilds = "ytcpp_player_builds_total";
+    constexpr const char* PlayerBuildDuration = "ytcpp_player_build_duration_seconds";
+}
+
+namespace Objects {
+    namespace Artifact {
+        constexpr const char* Engine = "engine";
+        constexpr const char* SignatureTimestamp = "signature_timestamp";
+        constexpr const char* SigFunction = "sig_function";
+        constexpr const char* NsigFunction = "nsig_function";
+        constexpr const char* SigFunctionCode = "sig_function_code";
+        constexpr const char* SignatureObjectCode = "signature_object_code";
+        constexpr const char* Bytecode = "bytecode";
+        constexpr const char* Checksum = "checksum";
+    }
+}
+
 namespace Regex {
-    constexpr const char* ExtractPlayerId = R"(https:\\\/\\\/www\.youtube\.com\\\/s\\\/player\\\/(.+?)\\\/)";
-    constexpr const char* ExtractSignatureTimestamp = R"(signatureTimestamp:(\d+))";
-    constexpr const char* ExtractSignatureFunction = R"(([a-zA-Z0-9_$]+)\s*=\s*function\(\s*[a-zA-Z0-9_$]+\s*\)\s*\{\s*[a-zA-Z0-9_$]+\s*=\s*[a-zA-Z0-9_$]+\.split\(\s*[a-zA-Z0-9_$\[\]\"]+\s*\)\s*;([a-zA-Z0-9_$]+)\s*[^\}]+;\s*return\s+[a-zA-Z0-9_$]+\.join\(\s*[a-zA-Z0-9_$\[\]\"]+\s*\)\s*\})";
-    constexpr const char* ExtractSignatureObject = R"(var {}=\{{[\s\S]*?\}};)";
-    constexpr const char* ExtractNFunction = R"(([a-zA-Z0-9_$]+)\s*=\s*function\(\s*[a-zA-Z0-9_$]+\s*\)\s*\{var [a-zA-Z0-9_$]+=(?:[a-zA-Z0-9_$]+\.split|String\.prototype\.split\.call)\([\s\S]*?return (?:[a-zA-Z0-9_$]+\.join|Array\.prototype\.join\.call)\(.*?\)\s*\};)";
-    constexpr const char* ExtractNFunctionSecretVariable = R"(if\s*\(\s*typeof\s*([a-zA-Z0-9_$]+)\s*===\s*([a-zA-Z0-9_$\"]+)[\d\[\]]*\s*\))";
+    const boost::regex ExtractPlayerId(R"(https:\\\/\\\/www\.youtube\.com\\\/s\\\/player\\\/(.+?)\\\/)");
+    const boost::regex ExtractSignatureFunction(R"(([a-zA-Z0-9_$]+)\s*=\s*function\(\s*[a-zA-Z0-9_$]+\s*\)\s*\{\s*[a-zA-Z0-9_$]+\s*=\s*[a-zA-Z0-9_$]+\.split\(\s*[a-zA-Z0-9_$\[\]\"]+\s*\)\s*;([a-zA-Z0-9_$]+)\s*[^\}]+;\s*return\s+[a-zA-Z0-9_$]+\.join\(\s*[a-zA-Z0-9_$\[\]\"]+\s*\)\s*\})");
+    const boost::regex ExtractNFunction(R"(([a-zA-Z0-9_$]+)\s*=\s*function\(\s*[a-zA-Z0-9_$]+\s*\)\s*\{var [a-zA-Z0-9_$]+=(?:[a-zA-Z0-9_$]+\.split|String\.prototype\.split\.call)\([\s\S]*?return (?:[a-zA-Z0-9_$]+\.join|Array\.prototype\.join\.call)\(.*?\)\s*\};)");
+    const boost::regex ExtractNFunctionSecretVariable(R"(if\s*\(\s*typeof\s*([a-zA-Z0-9_$]+)\s*===\s*([a-zA-Z0-9_$\"]+)[\d\[\]]*\s*\))");
 }
 
-std::string Player::GetPlayerId() {
-    Curl::Response response = Curl::Get(Urls::IframeApi);
+namespace Scanner {
+    using Definitions = std::map<std::string, std::vector<size_t>, std::less<>>;
+
+    static bool IsNameCharacter(char character) {
+        return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z')
+            || (character >= '0' && character <= '9') || character == '_' || character == '$';
+    }
+
+    static std::optional<int> ExtractSignatureTimestamp(std::string_view code) {
+        constexpr std::string_view Key = "signatureTimestamp:";
+        for (size_t position = code.find(Key); position != std::string_view::npos; position = code.find(Key, position + 1)) {
+            size_t begin = position + Key.size(), end = begin;
+            while (end < code.size() && code[end] >= '0' && code[end] <= '9')
+                ++end;
+            if (end != begin)
+                return std::stoi(std::string(code.substr(begin, end - begin)));
+        }
+        return std::nullopt;
+    }
+
+    // Collects offsets of every "var <name>=" statement for the requested names in one sweep.
+    static Definitions IndexDefinitions(std::string_view code, const std::vector<std::string>& names) {
+        Definitions definitions;
+        for (const std::string& name : names)
+            definitions.emplace(name, std::vector<size_t>());
+
+        constexpr std::string_view Keyword = "var ";
+        for (size_t position = code.find(Keyword); position != std::string_view::npos; position = code.find(Keyword, position + 1)) {
+            size_t begin = position + Keyword.size(), end = begin;
+            while (end < code.size() && IsNameCharacter(code[end]))
+                ++end;
+            if (end == begin || end == code.size() || code[end] != '=')
+                continue;
+
+            auto definition = definitions.find(code.substr(begin, end - begin));
+            if (definition != definitions.end())
+                definition->second.push_back(position);
+        }
+        return definitions;
+    }
+
+    static std::optional<std::string> ExtractDefinition(
+        std::string_view code, const Definitions& definitions, const std::string& name,
+        std::string_view terminator, std::string_view valuePrefix = {}
+    ) {
+        auto definition = definitions.find(name);
+        if (definition == definitions.end())
+            return std::nullopt;
+
+        for (size_t position : definition->second) {
+            size_t valueBegin = position + 4 + name.size() + 1;
+            if (!code.substr(valueBegin).starts_with(valuePrefix))
+                continue;
+
+            size_t end = code.find(terminator, valueBegin + std::max<size_t>(valuePrefix.size(), 1));
+            if (end != std::string_view::npos)
+                return std::string(code.substr(position, end + terminator.size() - position));
+        }
+        return std::nullopt;
+    }
+}
+
+static void RecordBuild(const char* source, const Stopwatch& stopwatch) {
+    Metrics::GetCounter(Names::PlayerBuilds, { {"source", source} }).add();
+    Metrics::GetHistogram(Names::PlayerBuildDuration, { {"source", source} }).observe(stopwatch.us());
+}
+
+static Player::NsigCache& GetNsigCache() {
+    static Player::NsigCache cache(4096);
+    return cache;
+}
+
+static std::atomic<std::shared_ptr<SharedTable>>& GetSharedCache() {
+    static std::atomic<std::shared_ptr<SharedTable>> cache;
+    return cache;
+}
+
+static std::string ExtractPlayerId(const Curl::Response& response) {
     if (response.code != 200)
         throw YTCPP_LOCATED_ERROR("Couldn't get iframe API response [response code: {}]", response.code).withDump(response.data);
 
     boost::smatch matches;
-    if (!boost::regex_search(response.data, matches, boost::regex(Regex::ExtractPlayerId)))
+    if (!boost::regex_search(response.data, matches, Regex::ExtractPlayerId))
         throw YTCPP_LOCATED_ERROR("Couldn't extract player ID from iframe API response").withDump(response.data);
     return matches.str(1);
 }
 
+std::string Player::GetPlayerId() {
+    return ExtractPlayerId(Curl::Get(Urls::IframeApi));
+}
+
+Task<std::string> Player::GetPlayerIdAsync(std::stop_token stopToken, Context& context) {
+    std::optional<Curl::Operation> operation;
+    {
+        Context::Scope scope(context);
+        operation.emplace(Curl::AsyncGet(Urls::IframeApi, {}, std::move(stopToken)));
+    }
+    co_return ExtractPlayerId(co_await std::move(*operation));
+}
+
+Player::NsigCache::Stats Player::NsigCacheStats() {
+    return GetNsigCache().stats();
+}
+
+void Player::UseSharedCache(const std::string& name, size_t slotCount) {
+    GetSharedCache().store(std::make_shared<SharedTable>(name, slotCount));
+    Logger::Debug("Player: Using \"{}\" shared decipher cache", name);
+}
+
+void Player::DisableSharedCache() {
+    GetSharedCache().store(nullptr);
+}
+
+std::optional<SharedTable::Stats> Player::SharedCacheStats() {
+    std::shared_ptr<SharedTable> sharedCache = GetSharedCache().load();
+    if (!sharedCache)
+        return std::nullopt;
+    return sharedCache->stats();
+}
+
 Player::Player(const std::string& id)
     : m_id(id) {
     Stopwatch stopwatch;
+    if (loadArtifact()) {
+        stopwatch.stop();
+        RecordBuild("snapshot", stopwatch);
+        Logger::Debug(
+            "Player \"{}\": Loaded from bytecode snapshot ({} ms, sigfunc: {} ({}), nsigfunc: {})",
+            m_id, stopwatch.ms(), m_sigFunction, m_cipher ? "native" : "interpreted", m_nsigFunction
+        );
+        return;
+    }
+
     Curl::Response response = Curl::Get(fmt::format(Urls::PlayerCode, m_id));
     if (response.code != 200) {
         throw YTCPP_LOCATED_ERROR(
@@ -44,59 +198,243 @@ Player::Player(const std::string& id)
             m_id, response.code
         ).withDump(response.data);
     }
+    build(response.data, stopwatch);
+}
 
-    boost::smatch matches;
-    if (!boost::regex_search(response.data, matches, boost::regex(Regex::ExtractSignatureTimestamp)))
-        throw YTCPP_LOCATED_ERROR("Couldn't extract signature timestamp from player code").withDump(response.data);
-    m_signatureTimestamp = std::stoi(matches.str(1));
+Player::Player(const std::string& id, const std::string& code)
+    : m_id(id) {
+    Stopwatch stopwatch;
+    build(code, stopwatch);
+}
 
-    if (!boost::regex_search(response.data, matches, boost::regex(Regex::ExtractSignatureFunction)))
-        throw YTCPP_LOCATED_ERROR("Couldn't extract signature function from player code").withDump(response.data);
-    m_interpreter.execute(matches.str(0));
-    m_sigFunction = matches.str(1);
+void Player::build(const std::string& code, Stopwatch& stopwatch) {
+    std::optional<int> signatureTimestamp = Scanner::ExtractSignatureTimestamp(code);
+    if (!signatureTimestamp)
+        throw YTCPP_LOCATED_ERROR("Couldn't extract signature timestamp from player code").withDump(code);
+    m_signatureTimestamp = *signatureTimestamp;
 
-    std::string encapsulatedObjectName = boost::regex_replace(matches.str(2), boost::regex(R"(\$)"), R"(\\$)");
-    if (!boost::regex_search(response.data, matches, boost::regex(fmt::format(R"(var {}=\{{[\s\S]*?\}};)", encapsulatedObjectName))))
-        throw YTCPP_LOCATED_ERROR("Couldn't extract signature object from player code").withDump(response.data);
-    m_interpreter.execute(matches.str(0));
+    boost::smatch matches;
+    if (!boost::regex_search(code, matches, Regex::ExtractSignatureFunction))
+        throw YTCPP_LOCATED_ERROR("Couldn't extract signature function from player code").withDump(code);
+    std::string sigFunctionCode = matches.str(0);
+    std::string signatureObjectName = matches.str(2);
+    m_sigFunction = matches.str(1);
 
-    if (!boost::regex_search(response.data, matches, boost::regex(Regex::ExtractNFunction)))
-        throw YTCPP_LOCATED_ERROR("Couldn't extract N signature function from player code").withDump(response.data);
+    if (!boost::regex_search(code, matches, Regex::ExtractNFunction))
+        throw YTCPP_LOCATED_ERROR("Couldn't extract N signature function from player code").withDump(code);
     std::string nFunctionCode = matches.str(0);
-    m_interpreter.execute(nFunctionCode);
     m_nsigFunction = matches.str(1);
 
-    if (boost::regex_search(nFunctionCode, matches, boost::regex(Regex::ExtractNFunctionSecretVariable))) {
-        std::string secretVariableName = matches.str(1);
-        std::string referenceVariableName = matches.str(2);
+    std::string secretVariableName, referenceVariableName;
+    if (boost::regex_search(nFunctionCode, matches, Regex::ExtractNFunctionSecretVariable)) {
+        secretVariableName = matches.str(1);
+        referenceVariableName = matches.str(2);
+    }
+
+    Scanner::Definitions definitions = Scanner::IndexDefinitions(
+        code, { signatureObjectName, secretVariableName, referenceVariableName }
+    );
+
+    std::optional<std::string> signatureObjectCode = Scanner::ExtractDefinition(code, definitions, signatureObjectName, "}};", "{");
+    if (!signatureObjectCode)
+        throw YTCPP_LOCATED_ERROR("Couldn't extract signature object from player code").withDump(code);
+    std::string source = fmt::format("{};\n{}\n{}\n", sigFunctionCode, *signatureObjectCode, nFunctionCode);
 
-        if (!boost::regex_search(response.data, matches, boost::regex(fmt::format(R"(var {}=.+?;)", secretVariableName))))
-            throw YTCPP_LOCATED_ERROR("Couldn't extract secret variable definition from player code").withDump(response.data);
-        m_interpreter.execute(matches.str(0));
+    if (!secretVariableName.empty()) {
+        std::optional<std::string> secretVariableCode = Scanner::ExtractDefinition(code, definitions, secretVariableName, ";");
+        if (!secretVariableCode)
+            throw YTCPP_LOCATED_ERROR("Couldn't extract secret variable definition from player code").withDump(code);
+        source += *secretVariableCode + '\n';
 
         if (referenceVariableName != "\"undefined\"") {
-            if (!boost::regex_search(response.data, matches, boost::regex(fmt::format(R"(var {}=.+?\.split\(";"\))", referenceVariableName))))
-                throw YTCPP_LOCATED_ERROR("Couldn't extract reference variable definition from player code").withDump(response.data);
-            m_interpreter.execute(matches.str(0));
+            std::optional<std::string> referenceVariableCode = Scanner::ExtractDefinition(code, definitions, referenceVariableName, R"(.split(";"))");
+            if (!referenceVariableCode)
+                throw YTCPP_LOCATED_ERROR("Couldn't extract reference variable definition from player code").withDump(code);
+            source += *referenceVariableCode + ";\n";
         }
     }
+
+    std::string bytecode = m_interpreter.compile(source);
+    m_interpreter.load(bytecode);
+    compileCipher(sigFunctionCode, *signatureObjectCode);
+    saveArtifact(bytecode, sigFunctionCode, *signatureObjectCode);
     stopwatch.stop();
+    RecordBuild("code", stopwatch);
 
-    Logger::Debug("Player \"{}\": Initialized ({} ms, sigfunc: {}, nsigfunc: {})", m_id, stopwatch.ms(), m_sigFunction, m_nsigFunction);
+    Logger::Debug(
+        "Player \"{}\": Initialized ({} ms, sigfunc: {} ({}), nsigfunc: {})",
+        m_id, stopwatch.ms(), m_sigFunction, m_cipher ? "native" : "interpreted", m_nsigFunction
+    );
 }
 
-std::string Player::prepareUrl(std::string url) const {
-    url = m_interpreter.execute(R"(decodeURIComponent("{}"))", url);
-    boost::smatch matches;
-    if (boost::regex_search(url, matches, boost::regex(R"(s=(.+)&sp=sig&url=(.+))"))) {
-        std::string signature = m_interpreter.execute(R"({}("{}"))", m_sigFunction, matches.str(1));
-        url = fmt::format("{}&sig={}", m_interpreter.execute(R"(decodeURIComponent("{}"))", matches.str(2)), signature);
+bool Player::loadArtifact() {
+    try {
+        Cache::Value contents = Cache::Read(fmt::format(Keys::PlayerArtifact, m_id));
+        if (!contents)
+            return false;
+
+        json artifact = json::from_cbor(*contents);
+        if (artifact.at(Objects::Artifact::Engine) != Js::Interpreter::EngineFingerprint())
+            return false;
+
+        // Engines don't validate bytecode, a corrupted snapshot must never reach the loader.
+        const json::binary_t& binary = artifact.at(Objects::Artifact::Bytecode).get_binary();
+        std::string bytecode(binary.begin(), binary.end());
+        if (artifact.at(Objects::Artifact::Checksum).get<uint64_t>() != Hash::Fnv1a(bytecode)) {
+            Logger::Warn("Player \"{}\": Bytecode snapshot checksum mismatch, rebuilding", m_id);
+            return false;
+        }
+
+        m_interpreter.load(bytecode);
+        m_signatureTimestamp = artifact.at(Objects::Artifact::SignatureTimestamp);
+        m_sigFunction = artifact.at(Objects::Artifact::SigFunction);
+        m_nsigFunction = artifact.at(Objects::Artifact::NsigFunction);
+        compileCipher(artifact.at(Objects::Artifact::SigFunctionCode), artifact.at(Objects::Artifact::SignatureObjectCode));
+        return true;
+    }
+    catch (const json::exception& error) {
+        Logger::Warn("Player \"{}\": Couldn't parse bytecode snapshot [error id: {}], rebuilding", m_id, error.id);
+    }
+    catch (const Js::Error& error) {
+        Logger::Warn("Player \"{}\": Couldn't load bytecode snapshot ({}), rebuilding", m_id, error.message());
+    }
+    catch (const Error& error) {
+        Logger::Warn("Player \"{}\": Couldn't read bytecode snapshot ({}), rebuilding", m_id, error.what());
+    }
+
+    m_interpreter = Js::Interpreter();
+    m_cipher.reset();
+    return false;
+}
+
+void Player::saveArtifact(const std::string& bytecode, const std::string& sigFunctionCode, const std::string& signatureObjectCode) const {
+    json artifact;
+    artifact[Objects::Artifact::Engine] = Js::Interpreter::EngineFingerprint();
+    artifact[Objects::Artifact::SignatureTimestamp] = m_signatureTimestamp;
+    artifact[Objects::Artifact::SigFunction] = m_sigFunction;
+    artifact[Objects::Artifact::NsigFunction] = m_nsigFunction;
+    artifact[Objects::Artifact::SigFunctionCode] = sigFunctionCode;
+    artifact[Objects::Artifact::SignatureObjectCode] = signatureObjectCode;
+    artifact[Objects::Artifact::Bytecode] = json::binary(std::vector<uint8_t>(bytecode.begin(), bytecode.end()));
+    artifact[Objects::Artifact::Checksum] = Hash::Fnv1a(bytecode);
+
+    try {
+        std::vector<uint8_t> contents = json::to_cbor(artifact);
+        Cache::Write(fmt::format(Keys::PlayerArtifact, m_id), std::string(contents.begin(), contents.end()));
+    }
+    catch (const Error& error) {
+        Logger::Warn("Player \"{}\": Couldn't save bytecode snapshot ({})", m_id, error.what());
     }
+}
+
+void Player::compileCipher(const std::string& functionCode, const std::string& objectCode) {
+    m_cipher = Cipher::Compile(functionCode, objectCode);
+    if (!m_cipher)
+        return;
+
+    // Native cipher is only trusted if it matches the interpreter on a probe signature.
+    std::string probe;
+    for (char character = '!'; character <= '~'; ++character) {
+        if (character != '"' && character != '\\')
+            probe += character;
+    }
+
+    std::string expected = m_interpreter.execute(R"({}("{}"))", m_sigFunction, probe);
+    if (m_cipher->apply(probe) != expected) {
+        Logger::Warn("Player \"{}\": Native signature cipher doesn't match interpreter, falling back", m_id);
+        m_cipher.reset();
+    }
+}
+
+std::string Player::prepareUrl(const std::string& url) const {
+    return prepareUrls({ url }).front();
+}
+
+std::vector<std::string> Player::prepareUrls(const std::vector<std::string>& urls) const {
+    std::vector<std::string> preparedUrls;
+    std::vector<std::string> signatures, nsignatures;
+    std::vector<std::pair<size_t, std::string>> signatureTargets;
+    std::vector<std::string> urlNsignatures;
+    std::map<std::string, std::optional<std::string>> nsignatureCache;
+    std::shared_ptr<SharedTable> sharedCache = GetSharedCache().load();
+    preparedUrls.reserve(urls.size());
+    urlNsignatures.reserve(urls.size());
+    for (const std::string& rawUrl : urls) {
+        // Ciphered formats carry "s", "sp" and "url" query parameters instead of a plain URL.
+        if (rawUrl.find("://") == std::string::npos) {
+            Url::Query cipher(rawUrl);
+            std::optional<std::string> url = cipher.get("url");
+            std::optional<std::string> signature = cipher.get("s");
+            if (!url || !signature)
+                throw YTCPP_LOCATED_ERROR("Couldn't extract URL and signature from signature cipher").withDetails(rawUrl);
+
+            preparedUrls.push_back(std::move(*url));
+            std::string signatureParameter = cipher.get("sp").value_or("sig");
+            if (m_cipher) {
+                preparedUrls.back() = Url::SetParameter(preparedUrls.back(), signatureParameter, m_cipher->apply(*signature));
+            }
+            else if (std::optional<std::string> deciphered = sharedCache ? sharedCache->get(fmt::format(Keys::Signature, m_id, *signature)) : std::nullopt) {
+                preparedUrls.back() = Url::SetParameter(preparedUrls.back(), signatureParameter, *deciphered);
+            }
+            else {
+                signatureTargets.emplace_back(preparedUrls.size() - 1, std::move(signatureParameter));
+                signatures.push_back(std::move(*signature));
+            }
+        }
+        else {
+            preparedUrls.push_back(rawUrl);
+        }
 
-    if (!boost::regex_search(url, matches, boost::regex(R"(&n=(.+?)&)")))
-        throw YTCPP_LOCATED_ERROR("Couldn't extract nsig from url").withDetails(url);
-    std::string nsignature = m_interpreter.execute(R"({}("{}"))", m_nsigFunction, matches.str(1));
-    return boost::regex_replace(url, boost::regex(R"(&n=(.+?)&)"), fmt::format("&n={}&", nsignature));
-} 
+        std::optional<std::string> nsignature = Url::Query(preparedUrls.back()).get("n");
+        if (!nsignature)
+            throw YTCPP_LOCATED_ERROR("Couldn't extract nsig from url").withDetails(preparedUrls.back());
+        if (!nsignatureCache.contains(*nsignature)) {
+            std::optional<std::string> transformed = GetNsigCache().get(fmt::format("{}:{}", m_id, *nsignature));
+            if (!transformed && sharedCache) {
+                transformed = sharedCache->get(fmt::format(Keys::Nsignature, m_id, *nsignature));
+                if (transformed)
+                    GetNsigCache().put(fmt::format("{}:{}", m_id, *nsignature), *transformed);
+            }
+            if (!transformed)
+                nsignatures.push_back(*nsignature);
+            nsignatureCache.emplace(*nsignature, std::move(transformed));
+        }
+        urlNsignatures.push_back(std::move(*nsignature));
+    }
+
+    if (!signatures.empty() || !nsignatures.empty()) {
+        json results;
+        try {
+            std::lock_guard lock(m_mutex);
+            results = json::parse(m_interpreter.execute(
+                R"(JSON.stringify([{}.map(function(s){{return {}(s)}}),{}.map(function(n){{return {}(n)}})]))",
+                json(signatures).dump(), m_sigFunction, json(nsignatures).dump(), m_nsigFunction
+            ));
+        }
+        catch (const json::exception& error) {
+            throw YTCPP_LOCATED_ERROR("Couldn't parse deciphered signatures [error id: {}]", error.id);
+        }
+
+        for (size_t index = 0; index < signatureTargets.size(); ++index) {
+            auto& [urlIndex, signatureParameter] = signatureTargets[index];
+            std::string signature = results.at(0).at(index);
+            if (sharedCache)
+                sharedCache->put(fmt::format(Keys::Signature, m_id, signatures[index]), signature);
+            preparedUrls[urlIndex] = Url::SetParameter(preparedUrls[urlIndex], signatureParameter, signature);
+        }
+
+        for (size_t index = 0; index < nsignatures.size(); ++index) {
+            std::string nsignature = results.at(1).at(index);
+            if (sharedCache)
+                sharedCache->put(fmt::format(Keys::Nsignature, m_id, nsignatures[index]), nsignature);
+            GetNsigCache().put(fmt::format("{}:{}", m_id, nsignatures[index]), nsignature);
+            nsignatureCache[nsignatures[index]] = std::move(nsignature);
+        }
+    }
+
+    for (size_t index = 0; index < preparedUrls.size(); ++index)
+        preparedUrls[index] = Url::SetParameter(preparedUrls[index], "n", *nsignatureCache.at(urlNsignatures[index]));
+    return preparedUrls;
+}
 
 } // namespace ytcpp
@@ -1,16 +1,170 @@
 #include "ytcpp/playlist.hpp"
 
+#include <algorithm>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "ytcpp/core/logger.hpp"
+#include "ytcpp/core/stopwatch.hpp"
 #include "ytcpp/innertube.hpp"
 #include "ytcpp/utility.hpp"
 
 namespace ytcpp {
 
-Playlist::Playlist(const std::string& playlistIdOrUrl) {
+constexpr size_t SyncAlignmentLength = 5;
+
+static Curl::Response CheckBrowseResponse(Curl::Response&& response) {
+    if (response.code != 200) {
+        throw YTCPP_LOCATED_ERROR(
+            "Couldn't get \"browse\" response [client: Tv, response code: {}]",
+            response.code
+        ).withDump(response.data);
+    }
+    return std::move(response);
+}
+
+static Curl::Response RequestBrowse(const json& data) {
+    return CheckBrowseResponse(Innertube::CallApi(Client::Type::Tv, "browse", data));
+}
+
+static Curl::Response RequestContinuation(const std::string& continuation, Context& context) {
+    Context::Scope scope(context);
+    return RequestBrowse({ {"continuation", continuation} });
+}
+
+static const json& TwoColumnRenderer(const json& response) {
+    return response.at("contents").at("tvBrowseRenderer").at("content").at("tvSurfaceContentRenderer").at("content").at("twoColumnRenderer");
+}
+
+static const json* FirstPageRenderer(const json& response) {
+    const json& rightColumn = TwoColumnRenderer(response).at("rightColumn");
+    if (!rightColumn.contains("playlistVideoListRenderer"))
+        return nullptr;
+    return &rightColumn.at("playlistVideoListRenderer");
+}
+
+static const json& ContinuationRenderer(const json& response) {
+    return response.at("continuationContents").at("playlistVideoListContinuation");
+}
+
+static const json& BylineItems(const json& response) {
+    return TwoColumnRenderer(response).at("leftColumn").at("entityMetadataRenderer").at("bylines").at(0).at("lineRenderer").at("items");
+}
+
+static int ExtractVideoCount(const json& response) {
+    return Utility::ExtractCount(BylineItems(response).at(3).at("lineItemRenderer").at("text"));
+}
+
+static std::string ExtractContinuation(const json& renderer) {
+    if (!renderer.contains("continuations"))
+        return {};
+    return renderer.at("continuations").at(0).at("nextContinuationData").at("continuation");
+}
+
+static Playlist::Snapshot::Entry MakeEntry(const Video& video) {
+    return {
+        video.id(), video.title(), video.channel(),
+        static_cast<uint32_t>(video.duration().total_seconds())
+    };
+}
+
+static std::vector<size_t> IncreasingSubsequence(const std::vector<size_t>& sequence) {
+    std::vector<size_t> tails, previous(sequence.size(), -1);
+    for (size_t index = 0; index < sequence.size(); ++index) {
+        auto tail = std::lower_bound(tails.begin(), tails.end(), sequence[index], [&](size_t tailIndex, size_t value) {
+            return sequence[tailIndex] < value;
+        });
+        if (tail != tails.begin())
+            previous[index] = *(tail - 1);
+        if (tail == tails.end())
+            tails.push_back(index);
+        else
+            *tail = index;
+    }
+
+    std::vector<size_t> result(tails.size());
+    size_t index = tails.empty() ? -1 : tails.back();
+    for (size_t position = result.size(); position > 0; --position) {
+        result[position - 1] = index;
+        index = previous[index];
+    }
+    return result;
+}
+
+Playlist::Snapshot Playlist::Snapshot::Deserialize(const std::string& data) {
+    try {
+        const json object = json::from_cbor(data);
+        std::vector<Entry> entries;
+        entries.reserve(object.at("entries").size());
+        for (const json& entry : object.at("entries"))
+            entries.push_back({ entry.at(0), entry.at(1), entry.at(2), entry.at(3) });
+        return { object.at("playlist"), std::move(entries) };
+    }
+    catch (const json::exception& error) {
+        throw YTCPP_LOCATED_ERROR("Couldn't parse playlist snapshot [error id: {}]", error.id);
+    }
+}
+
+std::string Playlist::Snapshot::serialize() const {
+    json entries = json::array();
+    for (const Entry& entry : m_entries)
+        entries.push_back({ entry.id, entry.title, entry.channel, entry.durationSeconds });
+
+    std::vector<uint8_t> data = json::to_cbor({ {"playlist", m_playlistId}, {"entries", std::move(entries)} });
+    return { data.begin(), data.end() };
+}
+
+std::future<Playlist> Playlist::Async(const std::string& playlistIdOrUrl, Context& context) {
+    return context.async(
+        [playlistIdOrUrl]() {
+            std::string playlistId = Utility::ExtractPlaylistId(playlistIdOrUrl);
+            Curl::Response response = RequestBrowse({ {"browseId", "VL" + playlistId} });
+            return std::pair(std::move(playlistId), std::move(response));
+        },
+        [&context](std::pair<std::string, Curl::Response>&& fetched) {
+            Playlist playlist;
+            playlist.m_context = &context;
+            playlist.m_id = std::move(fetched.first);
+            playlist.parse(fetched.second);
+            return playlist;
+        }
+    );
+}
+
+Task<Playlist> Playlist::Fetch(std::string playlistIdOrUrl, std::stop_token stopToken, Context& context) {
+    Playlist playlist;
+    playlist.m_context = &context;
+    {
+        Context::Scope scope(context);
+        playlist.m_id = Utility::ExtractPlaylistId(playlistIdOrUrl);
+    }
+
+    Task<Curl::Response> request = Innertube::CallApiAsync(Client::Type::Tv, "browse", { {"browseId", "VL" + playlist.m_id} }, stopToken, context);
+    Curl::Response response = CheckBrowseResponse(co_await std::move(request));
+    playlist.parse(response);
+    co_return playlist;
+}
+
+Playlist Playlist::Parse(const std::string& playlistId, const std::string& response, Context& context) {
+    Playlist playlist;
+    playlist.m_context = &context;
+    playlist.m_id = playlistId;
+    playlist.parse({ 200, {}, response });
+    return playlist;
+}
+
+Playlist::Playlist(const std::string& playlistIdOrUrl, Context& context)
+    : m_context(&context) {
+    Context::Scope scope(context);
     m_id = Utility::ExtractPlaylistId(playlistIdOrUrl);
     extract();
 }
 
-Playlist::Playlist(const json& object) {
+Playlist::Playlist(const json& object, Context& context)
+    : m_context(&context) {
     m_id = object.at("playlistId");
     m_title = Utility::ExtractString(object.at("title"));
     m_channel = Utility::ExtractString(object.at("shortBylineText"));
@@ -19,27 +173,20 @@ Playlist::Playlist(const json& object) {
 }
 
 void Playlist::extract() {
-    Curl::Response response = Innertube::CallApi(Client::Type::Tv, "browse", { {"browseId", "VL" + m_id} });
-    if (response.code != 200) {
-        throw YTCPP_LOCATED_ERROR(
-            "Couldn't get \"browse\" response [client: Tv, response code: {}]",
-            response.code
-        ).withDump(response.data);
-    }
+    parse(RequestBrowse({ {"browseId", "VL" + m_id} }));
+}
 
+void Playlist::parse(const Curl::Response& response) {
     try {
         const json responseJson = json::parse(response.data);
-        const json& twoColumnRenderer = responseJson.at("contents").at("tvBrowseRenderer").at("content").at("tvSurfaceContentRenderer").at("content").at("twoColumnRenderer");
-        const json& entityMetadataRenderer = twoColumnRenderer.at("leftColumn").at("entityMetadataRenderer");
+        const json& entityMetadataRenderer = TwoColumnRenderer(responseJson).at("leftColumn").at("entityMetadataRenderer");
         m_title = Utility::ExtractString(entityMetadataRenderer.at("title"));
 
-        const json& lineRendererItems = entityMetadataRenderer.at("bylines").at(0).at("lineRenderer").at("items");
-        m_channel = Utility::ExtractString(lineRendererItems.at(1).at("lineItemRenderer").at("text"));
-        m_videoCount = Utility::ExtractCount(lineRendererItems.at(3).at("lineItemRenderer").at("text"));
+        m_channel = Utility::ExtractString(BylineItems(responseJson).at(1).at("lineItemRenderer").at("text"));
+        m_videoCount = ExtractVideoCount(responseJson);
 
-        const json& rightColumn = twoColumnRenderer.at("rightColumn");
-        if (rightColumn.contains("playlistVideoListRenderer"))
-            parseVideos(rightColumn.at("playlistVideoListRenderer"));
+        if (const json* renderer = FirstPageRenderer(responseJson))
+            parseVideos(*renderer);
     }
     catch (const json::exception& error) {
         throw YTCPP_LOCATED_ERROR(
@@ -50,42 +197,46 @@ void Playlist::extract() {
 }
 
 void Playlist::parseVideos(const json& object) {
-    m_videos.reserve(m_videos.size() + object.size());
     for (const json& content : object.at("contents")) {
-        Video video = Video::ParseTileRenderer(content.at("tileRenderer"));
+        Video& video = m_videos.emplace_back(Video::ParseTileRenderer(content.at("tileRenderer")));
         if (m_thumbnails.empty())
             m_thumbnails = video.thumbnails();
-        m_videos.push_back(video);
     }
-    m_videos.shrink_to_fit();
 
-    if (object.contains("continuations"))
-        m_continuation = object.at("continuations").at(0).at("nextContinuationData").at("continuation");
+    m_continuation = ExtractContinuation(object);
 }
 
-Playlist::Iterator::pointer Playlist::discoverVideo(size_t index) {
-    if (m_videos.empty())
-        extract();
-    if (m_videos.size() - 1 >= index)
-        return m_videos.data() + index;
-    if (m_continuation.empty())
-        return nullptr;
+void Playlist::prefetchContinuation() {
+    if (m_continuation.empty() || m_prefetch.valid())
+        return;
+    m_prefetch = m_context->offload([continuation = m_continuation]() {
+        return RequestBrowse({ {"continuation", continuation} });
+    });
+}
 
-    Curl::Response response = Innertube::CallApi(Client::Type::Tv, "browse", { {"continuation", m_continuation} });
-    if (response.code != 200) {
-        throw YTCPP_LOCATED_ERROR(
-            "Couldn't get \"browse\" response [client: Tv, response code: {}]",
-            response.code
-        ).withDump(response.data);
-    }
-    m_continuation.clear();
+void Playlist::fetchContinuation() {
+    Stopwatch stopwatch;
+    bool prefetched = m_prefetch.valid();
+    Context::Pending<Curl::Response> prefetch = std::exchange(m_prefetch, {});
 
+    // The token is only replaced once the page parses, a failed request is retried by the next call.
+    Curl::Response response = prefetched ? prefetch.get() : RequestContinuation(m_continuation, *m_context);
+    stopwatch.stop();
+    Logger::Debug(
+        "Playlist \"{}\": Got continuation page ({} ms, {})",
+        m_id, stopwatch.ms(), prefetched ? "prefetched" : "requested"
+    );
+    parseContinuation(response);
+}
+
+void Playlist::parseContinuation(const Curl::Response& response) {
+    size_t previousSize = m_videos.size();
     try {
         const json responseJson = json::parse(response.data);
-        parseVideos(responseJson.at("continuationContents").at("playlistVideoListContinuation"));
-        return m_videos.data() + index;
+        parseVideos(ContinuationRenderer(responseJson));
     }
     catch (const json::exception& error) {
+        m_videos.erase(m_videos.begin() + previousSize, m_videos.end());
         throw YTCPP_LOCATED_ERROR(
             "Couldn't parse \"browse\" response JSON [client: Tv, error id: {}]",
             error.id
@@ -93,4 +244,187 @@ Playlist::Iterator::pointer Playlist::discoverVideo(size_t index) {
     }
 }
 
+Playlist::Iterator::pointer Playlist::discoverVideo(size_t index) {
+    Context::Scope scope(*m_context);
+    if (m_videos.empty())
+        extract();
+    if (index >= m_videos.size() && !m_continuation.empty())
+        fetchContinuation();
+    if (index >= m_videos.size())
+        return nullptr;
+
+    if (m_videos.size() - index <= m_prefetchDistance)
+        prefetchContinuation();
+    return &m_videos[index];
+}
+
+size_t Playlist::fetchAll(const PageCallback& callback, size_t limit) const {
+    int videoCount = -1;
+    return fetchPages(callback, limit, videoCount);
+}
+
+size_t Playlist::fetchPages(const PageCallback& callback, size_t limit, int& videoCount) const {
+    Context::Scope scope(*m_context);
+    Stopwatch stopwatch;
+    Curl::Response response = RequestBrowse({ {"browseId", "VL" + m_id} });
+    size_t pages = 0, fetched = 0;
+    while (true) {
+        std::vector<Video> videos;
+        Context::Pending<Curl::Response> nextPage;
+        try {
+            const json responseJson = json::parse(response.data);
+            if (!pages)
+                videoCount = ExtractVideoCount(responseJson);
+
+            const json* renderer = pages ? &ContinuationRenderer(responseJson) : FirstPageRenderer(responseJson);
+            if (!renderer)
+                break;
+
+            const json& contents = renderer->at("contents");
+            size_t count = limit ? std::min(contents.size(), limit - fetched) : contents.size();
+            std::string continuation = ExtractContinuation(*renderer);
+
+            // Next page is requested before this one is turned into videos.
+            if (!continuation.empty() && (!limit || fetched + count < limit)) {
+                nextPage = m_context->offload([continuation = std::move(continuation)]() {
+                    return RequestBrowse({ {"continuation", continuation} });
+                });
+            }
+
+            videos.reserve(count);
+            for (size_t index = 0; index < count; ++index)
+                videos.push_back(Video::ParseTileRenderer(contents.at(index).at("tileRenderer")));
+        }
+        catch (const json::exception& error) {
+            throw YTCPP_LOCATED_ERROR(
+                "Couldn't parse \"browse\" response JSON [client: Tv, error id: {}]",
+                error.id
+            ).withDump(response.data);
+        }
+
+        ++pages;
+        fetched += videos.size();
+        if (!callback(std::move(videos)) || !nextPage.valid())
+            break;
+        response = nextPage.get();
+    }
+
+    stopwatch.stop();
+    Logger::Debug("Playlist \"{}\": Fetched {} videos in {} pages ({} ms)", m_id, fetched, pages, stopwatch.ms());
+    return fetched;
+}
+
+Task<size_t> Playlist::fetchPage(std::stop_token stopToken) {
+    size_t previousSize = m_videos.size();
+    if (m_continuation.empty())
+        co_return 0;
+
+    // A page already requested by the iterator is reused rather than requested twice,
+    // a failed prefetch leaves the token in place for the next call.
+    Curl::Response response;
+    if (m_prefetch.valid()) {
+        if (stopToken.stop_requested())
+            throw YtError(YtError::Type::Cancelled, "Request cancelled");
+        Context::Pending<Curl::Response> prefetch = std::exchange(m_prefetch, {});
+        response = co_await prefetch;
+    }
+    else {
+        Task<Curl::Response> request = Innertube::CallApiAsync(Client::Type::Tv, "browse", { {"continuation", m_continuation} }, stopToken, *m_context);
+        response = CheckBrowseResponse(co_await std::move(request));
+    }
+
+    Context::Scope scope(*m_context);
+    parseContinuation(response);
+    co_return m_videos.size() - previousSize;
+}
+
+size_t Playlist::appendPage(const std::string& response) {
+    size_t previousSize = m_videos.size();
+    // A prefetch for the token this page answers would add it twice.
+    m_prefetch = {};
+    parseContinuation({ 200, {}, response });
+    return m_videos.size() - previousSize;
+}
+
+Playlist::Diff Playlist::sync(const Snapshot& previous) const {
+    Context::Scope scope(*m_context);
+    if (!previous.empty() && previous.playlistId() != m_id)
+        throw YTCPP_LOCATED_ERROR("Snapshot of playlist \"{}\" can't be synced with playlist \"{}\"", previous.playlistId(), m_id);
+
+    const std::vector<Snapshot::Entry>& previousEntries = previous.entries();
+    std::unordered_map<std::string_view, size_t> previousPositions;
+    for (size_t index = 0; index < previousEntries.size(); ++index)
+        previousPositions.emplace(previousEntries[index].id, index);
+
+    // Paging stops once the fetched tail lines up with the stored order and the stored
+    // remainder accounts for the rest of the playlist, as counted by the first page fetched here.
+    std::vector<Video> fetched;
+    std::optional<size_t> alignedAt;
+    int videoCount = -1;
+    fetchPages([&](std::vector<Video>&& videos) {
+        std::move(videos.begin(), videos.end(), std::back_inserter(fetched));
+        if (fetched.empty() || videoCount < 0)
+            return true;
+
+        auto position = previousPositions.find(fetched.back().id());
+        if (position == previousPositions.end())
+            return true;
+
+        size_t last = position->second, length = std::min(SyncAlignmentLength, fetched.size());
+        if (last + 1 < length || fetched.size() + previousEntries.size() - last - 1 != static_cast<size_t>(videoCount))
+            return true;
+        for (size_t offset = 1; offset < length; ++offset) {
+            if (fetched[fetched.size() - 1 - offset].id() != previousEntries[last - offset].id)
+                return true;
+        }
+
+        alignedAt = last;
+        return false;
+    }, 0, videoCount);
+
+    std::vector<Snapshot::Entry> entries;
+    entries.reserve(fetched.size() + (alignedAt ? previousEntries.size() - *alignedAt - 1 : 0));
+    for (const Video& video : fetched)
+        entries.push_back(MakeEntry(video));
+    if (alignedAt)
+        entries.insert(entries.end(), previousEntries.begin() + *alignedAt + 1, previousEntries.end());
+
+    Diff diff;
+    for (Video& video : fetched) {
+        if (!previousPositions.contains(video.id()))
+            diff.added.push_back(std::move(video));
+    }
+
+    std::unordered_set<std::string_view> currentIds;
+    std::vector<size_t> keptPositions, keptIndices;
+    for (size_t index = 0; index < entries.size(); ++index) {
+        currentIds.insert(entries[index].id);
+        auto position = previousPositions.find(entries[index].id);
+        if (position != previousPositions.end()) {
+            keptPositions.push_back(position->second);
+            keptIndices.push_back(index);
+        }
+    }
+    for (const Snapshot::Entry& entry : previousEntries) {
+        if (!currentIds.contains(entry.id))
+            diff.removed.push_back(entry.id);
+    }
+
+    // Videos outside the longest run that kept its relative order are the ones that moved.
+    std::vector<size_t> stable = IncreasingSubsequence(keptPositions);
+    for (size_t kept = 0, next = 0; kept < keptPositions.size(); ++kept) {
+        if (next < stable.size() && stable[next] == kept)
+            ++next;
+        else
+            diff.moved.push_back(entries[keptIndices[kept]].id);
+    }
+
+    Logger::Debug(
+        "Playlist \"{}\": Synced {} videos, fetched {} ({} added, {} removed, {} moved)",
+        m_id, entries.size(), fetched.size(), diff.added.size(), diff.removed.size(), diff.moved.size()
+    );
+    diff.snapshot = Snapshot(m_id, std::move(entries));
+    return diff;
+}
+
 } // namespace ytcpp
@@ -1,5 +1,8 @@
 #include "ytcpp/search.hpp"
 
+#include <iterator>
+#include <utility>
+
 #include <nlohmann/json.hpp>
 using nlohmann::json;
 
@@ -32,19 +35,109 @@ static SearchResults ParseSearchContents(const json& items, SearchResults::Type
     return results;
 }
 
-SearchResults QuerySearch(const std::string& query) {
-    Utility::CheckQuery(query);
-    Curl::Response response = Innertube::CallApi(Client::Type::TvEmbed, "search", { {"query", query} });
+static Curl::Response CheckSearchResponse(Curl::Response&& response) {
     if (response.code != 200) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't get \"search\" response [client: TvEmbed, response code: {}]",
             response.code
         ).withDump(response.data);
     }
+    return std::move(response);
+}
+
+static Curl::Response RequestSearch(const json& data) {
+    return CheckSearchResponse(Innertube::CallApi(Client::Type::TvEmbed, "search", data));
+}
+
+static const json& SectionList(const json& response) {
+    if (response.contains("continuationContents"))
+        return response.at("continuationContents").at("sectionListContinuation");
+    return response.at("contents").at("sectionListRenderer");
+}
+
+static std::string ExtractContinuation(const json& sectionList) {
+    if (sectionList.contains("continuations"))
+        return sectionList.at("continuations").at(0).at("nextContinuationData").at("continuation");
+
+    for (const json& section : sectionList.at("contents")) {
+        if (section.contains("continuationItemRenderer"))
+            return section.at("continuationItemRenderer").at("continuationEndpoint").at("continuationCommand").at("token");
+    }
+    return {};
+}
+
+SearchStream::SearchStream(const std::string& query, Context& context)
+    : m_context(&context)
+    , m_query(query)
+    , m_page(SearchResults::Type::QuerySearch, query) {
+    Utility::CheckQuery(query);
+}
 
+void SearchStream::loadPage(const Curl::Response& response) {
     try {
-        json contentsObject = json::parse(response.data).at("contents")
-            .at("sectionListRenderer").at("contents").at(0).at("itemSectionRenderer").at("contents");
+        const json responseJson = json::parse(response.data);
+        const json& sectionList = SectionList(responseJson);
+        std::string continuation = ExtractContinuation(sectionList);
+
+        SearchResults page(SearchResults::Type::QuerySearch, m_query);
+        for (const json& section : sectionList.at("contents")) {
+            if (!section.contains("itemSectionRenderer"))
+                continue;
+            SearchResults results = ParseSearchContents(section.at("itemSectionRenderer").at("contents"), SearchResults::Type::QuerySearch, m_query);
+            std::move(results.begin(), results.end(), std::back_inserter(page));
+        }
+
+        // The token is only replaced once the page parses, a failed page is requested again.
+        m_continuation = std::move(continuation);
+        m_page = std::move(page);
+        m_position = 0;
+        ++m_pages;
+    }
+    catch (const json::exception& error) {
+        throw YTCPP_LOCATED_ERROR(
+            "Couldn't parse \"search\" response JSON [client: TvEmbed, error id: {}]",
+            error.id
+        ).withDump(response.data);
+    }
+
+    // Next page is requested while the consumer goes through this one.
+    requestNextPage();
+}
+
+void SearchStream::requestNextPage() {
+    if (m_continuation.empty() || m_nextPage.valid())
+        return;
+    m_nextPage = m_context->offload([continuation = m_continuation]() {
+        return RequestSearch({ {"continuation", continuation} });
+    });
+}
+
+const Item* SearchStream::current() {
+    Context::Scope scope(*m_context);
+    if (m_pages == 0)
+        loadPage(RequestSearch({ {"query", m_query} }));
+
+    // Pages without extractable items are skipped.
+    while (m_position >= m_page.size()) {
+        if (m_continuation.empty())
+            return nullptr;
+
+        // A request that failed before is issued again.
+        requestNextPage();
+        Context::Pending<Curl::Response> nextPage = std::exchange(m_nextPage, {});
+        loadPage(nextPage.get());
+    }
+    return &m_page.at(m_position);
+}
+
+bool SearchStream::advance() {
+    ++m_position;
+    return current() != nullptr;
+}
+
+static SearchResults ParseQuerySearch(const Curl::Response& response, const std::string& query) {
+    try {
+        json contentsObject = SectionList(json::parse(response.data)).at("contents").at(0).at("itemSectionRenderer").at("contents");
         return ParseSearchContents(contentsObject, SearchResults::Type::QuerySearch, query);
     }
     catch (const json::exception& error) {
@@ -55,16 +148,21 @@ SearchResults QuerySearch(const std::string& query) {
     }
 }
 
-SearchResults RelatedSearch(const std::string& videoIdOrUrl) {
-    std::string videoId = Utility::ExtractVideoId(videoIdOrUrl);
-    Curl::Response response = Innertube::CallApi(Client::Type::TvEmbed, "next", { {"videoId", videoId} });
+static Curl::Response CheckNextResponse(Curl::Response&& response) {
     if (response.code != 200) {
         throw YTCPP_LOCATED_ERROR(
             "Couldn't get \"next\" response [client: TvEmbed, response code: {}]",
             response.code
         ).withDump(response.data);
     }
+    return std::move(response);
+}
 
+static Curl::Response RequestNext(const std::string& videoId) {
+    return CheckNextResponse(Innertube::CallApi(Client::Type::TvEmbed, "next", { {"videoId", videoId} }));
+}
+
+static SearchResults ParseRelatedSearch(const Curl::Response& response, const std::string& videoId) {
     try {
         json contentsObject = json::parse(response.data).at("contents").at("singleColumnWatchNextResults").at("results")
             .at("results").at("contents").at(2).at("shelfRenderer").at("content").at("horizontalListRenderer").at("items");
@@ -78,4 +176,59 @@ SearchResults RelatedSearch(const std::string& videoIdOrUrl) {
     }
 }
 
+SearchResults QuerySearch(const std::string& query, Context& context) {
+    Context::Scope scope(context);
+    Utility::CheckQuery(query);
+    return ParseQuerySearch(RequestSearch({ {"query", query} }), query);
+}
+
+SearchResults RelatedSearch(const std::string& videoIdOrUrl, Context& context) {
+    Context::Scope scope(context);
+    std::string videoId = Utility::ExtractVideoId(videoIdOrUrl);
+    return ParseRelatedSearch(RequestNext(videoId), videoId);
+}
+
+std::future<SearchResults> QuerySearchAsync(const std::string& query, Context& context) {
+    return context.async(
+        [query]() {
+            Utility::CheckQuery(query);
+            return RequestSearch({ {"query", query} });
+        },
+        [query](Curl::Response&& response) {
+            return ParseQuerySearch(response, query);
+        }
+    );
+}
+
+std::future<SearchResults> RelatedSearchAsync(const std::string& videoIdOrUrl, Context& context) {
+    return context.async(
+        [videoIdOrUrl]() {
+            std::string videoId = Utility::ExtractVideoId(videoIdOrUrl);
+            Curl::Response response = RequestNext(videoId);
+            return std::pair(std::move(videoId), std::move(response));
+        },
+        [](std::pair<std::string, Curl::Response>&& fetched) {
+            return ParseRelatedSearch(fetched.second, fetched.first);
+        }
+    );
+}
+
+Task<SearchResults> FetchQuerySearch(std::string query, std::stop_token stopToken, Context& context) {
+    Utility::CheckQuery(query);
+    Task<Curl::Response> request = Innertube::CallApiAsync(Client::Type::TvEmbed, "search", { {"query", query} }, stopToken, context);
+    Curl::Response response = CheckSearchResponse(co_await std::move(request));
+
+    Context::Scope scope(context);
+    co_return ParseQuerySearch(response, query);
+}
+
+Task<SearchResults> FetchRelatedSearch(std::string videoIdOrUrl, std::stop_token stopToken, Context& context) {
+    std::string videoId = Utility::ExtractVideoId(videoIdOrUrl);
+    Task<Curl::Response> request = Innertube::CallApiAsync(Client::Type::TvEmbed, "next", { {"videoId", videoId} }, stopToken, context);
+    Curl::Response response = CheckNextResponse(co_await std::move(request));
+
+    Context::Scope scope(context);
+    co_return ParseRelatedSearch(response, videoId);
+}
+
 } // namespace ytcpp
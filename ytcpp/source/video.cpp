@@ -1,7 +1,10 @@
 #include "ytcpp/video.hpp"
 
+#include <utility>
+
 #include "ytcpp/core/error.hpp"
 #include "ytcpp/innertube.hpp"
+#include "ytcpp/negative_cache.hpp"
 #include "ytcpp/utility.hpp"
 #include "ytcpp/yt_error.hpp"
 
@@ -36,23 +39,24 @@ Video Video::ParseTileRenderer(const json& object) {
     return video;
 }
 
-Video::Video(const std::string& videoIdOrUrl) {
-    m_id = Utility::ExtractVideoId(videoIdOrUrl);
-    extract();
-}
-
-void Video::extract() {
-    Curl::Response response = Innertube::CallApi(Client::Type::Tv, "player", { {"videoId", m_id} });
+static Curl::Response CheckPlayerResponse(const char* clientName, Curl::Response&& response) {
     if (response.code != 200) {
         throw YTCPP_LOCATED_ERROR(
-            "Couldn't get \"player\" response [client: Tv, response code: {}]",
-            response.code
+            "Couldn't get \"player\" response [client: {}, response code: {}]",
+            clientName, response.code
         ).withDump(response.data);
     }
+    return std::move(response);
+}
 
+static Curl::Response RequestPlayer(Client::Type client, const char* clientName, const std::string& videoId) {
+    return CheckPlayerResponse(clientName, Innertube::CallApi(client, "player", { {"videoId", videoId} }));
+}
+
+static void CheckPlayability(const std::string& videoId, const Curl::Response& response) {
     try {
         const json responseJson = json::parse(response.data);
-        Utility::CheckPlayability(responseJson.at("playabilityStatus"));
+        NegativeCache::CheckPlayability(videoId, responseJson.at("playabilityStatus"));
     }
     catch (const json::exception& error) {
         throw YTCPP_LOCATED_ERROR(
@@ -60,15 +64,61 @@ void Video::extract() {
             error.id
         ).withDump(response.data);
     }
+}
 
-    response = Innertube::CallApi(Client::Type::TvEmbed, "player", { {"videoId", m_id} });
-    if (response.code != 200) {
-        throw YTCPP_LOCATED_ERROR(
-            "Couldn't get \"player\" response [client: TvEmbed, response code: {}]",
-            response.code
-        ).withDump(response.data);
+std::future<Video> Video::Async(const std::string& videoIdOrUrl, Context& context) {
+    return context.async(
+        [videoIdOrUrl]() {
+            std::string videoId = Utility::ExtractVideoId(videoIdOrUrl);
+            NegativeCache::Check(videoId);
+            CheckPlayability(videoId, RequestPlayer(Client::Type::Tv, "Tv", videoId));
+            Curl::Response response = RequestPlayer(Client::Type::TvEmbed, "TvEmbed", videoId);
+            return std::pair(std::move(videoId), std::move(response));
+        },
+        [](std::pair<std::string, Curl::Response>&& responses) {
+            auto& [videoId, response] = responses;
+            Video video;
+            video.m_id = std::move(videoId);
+            video.parse(response);
+            return video;
+        }
+    );
+}
+
+Task<Video> Video::Fetch(std::string videoIdOrUrl, std::stop_token stopToken, Context& context) {
+    Video video;
+    {
+        Context::Scope scope(context);
+        video.m_id = Utility::ExtractVideoId(videoIdOrUrl);
+        NegativeCache::Check(video.m_id);
+    }
+
+    Task<Curl::Response> request = Innertube::CallApiAsync(Client::Type::Tv, "player", { {"videoId", video.m_id} }, stopToken, context);
+    Curl::Response playabilityResponse = CheckPlayerResponse("Tv", co_await std::move(request));
+    {
+        Context::Scope scope(context);
+        CheckPlayability(video.m_id, playabilityResponse);
     }
 
+    request = Innertube::CallApiAsync(Client::Type::TvEmbed, "player", { {"videoId", video.m_id} }, stopToken, context);
+    Curl::Response response = CheckPlayerResponse("TvEmbed", co_await std::move(request));
+    video.parse(response);
+    co_return video;
+}
+
+Video::Video(const std::string& videoIdOrUrl, Context& context) {
+    Context::Scope scope(context);
+    m_id = Utility::ExtractVideoId(videoIdOrUrl);
+    extract();
+}
+
+void Video::extract() {
+    NegativeCache::Check(m_id);
+    CheckPlayability(m_id, RequestPlayer(Client::Type::Tv, "Tv", m_id));
+    parse(RequestPlayer(Client::Type::TvEmbed, "TvEmbed", m_id));
+}
+
+void Video::parse(const Curl::Response& response) {
     try {
         const json responseJson = json::parse(response.data);
         const json& videoDetails = responseJson.at("videoDetails");